@@ -0,0 +1,107 @@
+#ifndef ALLOCGC_CARD_TABLE_HPP
+#define ALLOCGC_CARD_TABLE_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+
+#include <liballocgc/details/utils/utility.hpp>
+#include <liballocgc/details/constants.hpp>
+#include <liballocgc/gc_common.hpp>
+
+namespace allocgc { namespace details { namespace allocators {
+
+/**
+ * Card table for a contiguous range of memory, one byte per CARD_SIZE bytes.
+ * Write barrier dirties the card of the updated slot by a single store,
+ * and the collector scans only the cells lying on the dirty cards instead of remembering each stored pointer.
+ *
+ * Like the page table, table memory is committed lazily and is never released.
+ */
+class card_table : private utils::noncopyable, private utils::nonmovable
+{
+    typedef std::atomic<std::uint8_t> card_t;
+public:
+    static const size_t CARD_SIZE_LOG2 = 9;
+    static const size_t CARD_SIZE = (size_t) 1 << CARD_SIZE_LOG2;
+
+    constexpr card_table()
+        : m_base(0)
+        , m_size(0)
+        , m_cards(nullptr)
+        , m_used_size(0)
+    {}
+
+    // can be called only once, before any memory of the range is used
+    void init(const byte* base, size_t size);
+
+    inline bool contains(const byte* mem) const
+    {
+        return reinterpret_cast<std::uintptr_t>(mem) - m_base < m_size;
+    }
+
+    // returns false if the memory is not covered by the table
+    inline bool dirty(const byte* mem)
+    {
+        if (!contains(mem)) {
+            return false;
+        }
+        m_cards[card_idx(mem)].store(DIRTY, std::memory_order_release);
+        return true;
+    }
+
+    inline bool is_dirty(const byte* mem) const
+    {
+        return m_cards[card_idx(mem)].load(std::memory_order_relaxed) == DIRTY;
+    }
+
+    // extends the part of the range which is scanned for dirty cards, called when the memory is indexed
+    void cover(const byte* mem, size_t size)
+    {
+        assert(contains(mem) && contains(mem + size - 1));
+        size_t last = card_idx(mem + size - 1);
+        size_t used_size = m_used_size.load(std::memory_order_relaxed);
+        while (used_size < last + 1 && !m_used_size.compare_exchange_weak(used_size, last + 1)) {}
+    }
+
+    /**
+     * Cleans the dirty cards in the address order and calls f(card_begin, card_end) for each of them.
+     * Card is cleaned before the call, so that stores made after the card has been scanned dirty it again.
+     */
+    template <typename Functor>
+    void clean(Functor&& f)
+    {
+        size_t used_size = m_used_size.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < used_size; ++i) {
+            if (m_cards[i].load(std::memory_order_relaxed) == CLEAN) {
+                continue;
+            }
+            if (m_cards[i].exchange(CLEAN, std::memory_order_acquire) == DIRTY) {
+                byte* card = reinterpret_cast<byte*>(m_base + (i << CARD_SIZE_LOG2));
+                f(card, card + CARD_SIZE);
+            }
+        }
+    }
+
+    // cleans all the cards without scanning them
+    void clear();
+private:
+    static const std::uint8_t CLEAN = 0;
+    static const std::uint8_t DIRTY = 1;
+
+    inline size_t card_idx(const byte* mem) const
+    {
+        assert(contains(mem));
+        return (reinterpret_cast<std::uintptr_t>(mem) - m_base) >> CARD_SIZE_LOG2;
+    }
+
+    std::uintptr_t      m_base;
+    size_t              m_size;
+    card_t*             m_cards;
+    std::atomic<size_t> m_used_size;
+};
+
+}}}
+
+#endif //ALLOCGC_CARD_TABLE_HPP
@@ -2,6 +2,8 @@
 #define ALLOCGC_GC_BOX_HPP
 
 #include <cassert>
+#include <cstdint>
+#include <utility>
 
 #include <liballocgc/details/utils/utility.hpp>
 #include <liballocgc/details/gc_interface.hpp>
@@ -95,9 +97,19 @@ public:
         return get_obj_start(cell_start);
     }
 
-    static void trace(byte* cell_start, const gc_trace_callback& cb)
+    // Visitor is a functor taking gc_handle*, it is passed as template parameter
+    // so that the visitor's call can be inlined into the loop over pointer fields
+    template <typename Visitor>
+    static void trace(byte* cell_start, Visitor&& visitor)
+    {
+        assert(cell_start);
+        trace(cell_start, 0, get_obj_count(cell_start), std::forward<Visitor>(visitor));
+    }
+
+    // traces only objects of the array with indices in range [obj_begin, obj_end)
+    template <typename Visitor>
+    static void trace(byte* cell_start, size_t obj_begin, size_t obj_end, Visitor&& visitor)
     {
-        assert(cb);
         assert(cell_start);
         assert(get_type_meta(cell_start));
 
@@ -106,9 +118,21 @@ public:
 
         assert(type_meta);
         assert(meta->object_count() > 0);
-        byte*  obj      = get_obj_start(cell_start);
-        size_t obj_cnt  = meta->object_count();
+        assert(obj_begin <= obj_end && obj_end <= meta->object_count());
         size_t obj_size = type_meta->type_size();
+        byte*  obj      = get_obj_start(cell_start) + obj_begin * obj_size;
+
+        std::uint64_t mask = type_meta->pointers_mask();
+        if (mask != 0) {
+            for (size_t i = obj_begin; i < obj_end; i++) {
+                gc_handle* handles = reinterpret_cast<gc_handle*>(obj);
+                for (std::uint64_t m = mask; m != 0; m &= m - 1) {
+                    visitor(handles + __builtin_ctzll(m));
+                }
+                obj += obj_size;
+            }
+            return;
+        }
 
         auto   offsets     = type_meta->offsets();
         size_t offsets_cnt = offsets.size();
@@ -116,9 +140,9 @@ public:
             return;
         }
 
-        for (size_t i = 0; i < obj_cnt; i++) {
+        for (size_t i = obj_begin; i < obj_end; i++) {
             for (size_t j = 0; j < offsets_cnt; j++) {
-                cb(reinterpret_cast<gc_handle*>(obj + offsets[j]));
+                visitor(reinterpret_cast<gc_handle*>(obj + offsets[j]));
             }
             obj += obj_size;
         }
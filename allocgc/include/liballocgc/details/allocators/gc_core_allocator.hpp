@@ -11,8 +11,11 @@
 
 #include <liballocgc/details/allocators/allocator_tag.hpp>
 #include <liballocgc/details/allocators/sys_allocator.hpp>
+#include <liballocgc/details/allocators/reserved_range_allocator.hpp>
 #include <liballocgc/details/allocators/bucket_allocator.hpp>
 #include <liballocgc/details/allocators/freelist_allocator.hpp>
+#include <liballocgc/details/threads/numa_topology.hpp>
+#include <liballocgc/details/utils/dynarray.hpp>
 #include <liballocgc/details/constants.hpp>
 #include <liballocgc/details/logging.hpp>
 #include <liballocgc/gc_common.hpp>
@@ -47,44 +50,72 @@ public:
     gc_core_allocator& operator=(const gc_core_allocator&) = default;
     gc_core_allocator& operator=(gc_core_allocator&&) = default;
 
-    byte* allocate(size_t size);
+    // memory should be deallocated to the page pool of the same NUMA node it was allocated from,
+    // so callers keep the node along with the memory (e.g. in its descriptor)
+    byte* allocate(size_t size, size_t numa_node);
+    void deallocate(byte* ptr, size_t size, size_t numa_node);
 
-    void deallocate(byte* ptr, size_t size);
+    // heap-size accounting is lock-free, so memory cached by thread-local allocators
+    // can be accounted without touching the page pools
+    bool increase_heap_size(size_t size);
+    void decrease_heap_size(size_t size);
+
+    // return pages that are not accounted in heap size anymore
+    void deallocate_pages(byte* ptr, size_t size, size_t numa_node);
+
+    size_t numa_nodes_count() const;
 
     size_t shrink();
 
     memory_range_type memory_range();
 
+    size_t heap_size() const;
+    size_t heap_limit() const;
+
     void set_heap_limit(size_t limit);
     void expand_heap(double increase_factor = INCREASE_FACTOR);
 
+    // part of the heap limit at which incremental collector starts marking
+    void set_mark_trigger(double trigger);
+
     void notify_gc();
 
     gc_runstat gc(const gc_options& options);
+
+    // allocators report the allocated memory, so that the collector can do marking work proportional to it
+    void mark_increment(size_t alloc_size);
 private:
-    typedef freelist_allocator<sys_allocator> freelist_alloc_t;
-    typedef freelist_allocator<sys_allocator> fixsize_page_alloc_t;
+    typedef freelist_allocator<reserved_range_allocator> freelist_alloc_t;
+    typedef freelist_allocator<reserved_range_allocator> fixsize_page_alloc_t;
     typedef bucket_allocator<fixsize_page_alloc_t, page_bucket_policy> bucket_alloc_t;
 
     typedef std::mutex mutex_t;
 
+    struct node_page_pool
+    {
+        bucket_alloc_t m_bucket_alloc;
+        freelist_alloc_t m_freelist;
+        mutex_t m_mutex;
+    };
+
     static const size_t HEAP_START_LIMIT;
 
     static const double INCREASE_FACTOR;
     static const double MARK_THRESHOLD;
     static const double COLLECT_THRESHOLD;
 
-    bool increase_heap_size(size_t size, std::unique_lock<mutex_t>* lock);
-    void decrease_heap_size(size_t size);
+    // allocated memory between two slices of incremental marking
+    static const size_t MARK_INCREMENT_PERIOD;
 
     gc_launcher* m_gc_launcher;
-    size_t m_heap_size;
-    size_t m_heap_limit;
+    std::atomic<size_t> m_heap_size;
+    std::atomic<size_t> m_heap_limit;
     size_t m_heap_maxlimit;
-    bucket_alloc_t m_bucket_alloc;
-    freelist_alloc_t m_freelist;
-    mutex_t m_mutex;
-    bool m_mark_threshold;
+    // page pools per NUMA node, mutex of the pool guards only refills from the OS
+    utils::dynarray<node_page_pool> m_pools;
+    std::atomic<double> m_mark_trigger;
+    std::atomic<bool> m_mark_threshold;
+    std::atomic<size_t> m_mark_increment_size;
 };
 
 }}}
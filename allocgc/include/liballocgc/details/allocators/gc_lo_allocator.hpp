@@ -116,6 +116,10 @@ public:
     gc_collect_stat collect(compacting::forwarding& frwd);
     void fix(const compacting::forwarding& frwd);
     void finalize();
+    void unpin();
+
+    // calls the callback for each live (i.e. marked and initialized) cell
+    void trace_live(const gc_cell_callback& cb);
 
     gc_memstat stats();
 private:
@@ -162,8 +166,9 @@ private:
     memory_iterator memory_begin();
     memory_iterator memory_end();
 
-    byte* allocate_blk(size_t size);
-    void  deallocate_blk(byte* ptr, size_t size);
+    // blocks are returned to the page pool of the NUMA node they were allocated from
+    byte* allocate_blk(size_t size, size_t numa_node);
+    void  deallocate_blk(byte* ptr, size_t size, size_t numa_node);
 
     list_alloc_t m_alloc;
     mutex_t      m_mutex;
@@ -7,17 +7,44 @@
 
 namespace allocgc { namespace details { namespace allocators {
 
+/**
+ * Kind of the descriptor allows to call methods of the known descriptors without virtual dispatch
+ * (e.g. marker switches on the kind in its inner loop).
+ * Cells of POOL and OBJECT descriptors are laid out by gc_box.
+ */
+enum class gc_descriptor_kind {
+      POOL
+    , OBJECT
+    , OTHER
+};
+
 class gc_memory_descriptor
 {
 public:
+    explicit gc_memory_descriptor(gc_descriptor_kind kind = gc_descriptor_kind::OTHER)
+        : m_kind(kind)
+    {}
+
     virtual ~gc_memory_descriptor() {}
 
+    gc_descriptor_kind kind() const
+    {
+        return m_kind;
+    }
+
     virtual bool get_mark(byte* ptr) const = 0;
     virtual bool get_pin(byte* ptr) const = 0;
 
     virtual void set_mark(byte* ptr, bool mark) = 0;
     virtual void set_pin(byte* ptr, bool pin) = 0;
 
+    /**
+     * Atomically marks the cell, returns true if the bit has been set by this call
+     * and false if the cell has been already marked.
+     * Concurrent marking workers use it so that each cell is pushed and traced exactly once.
+     */
+    virtual bool try_mark(byte* ptr) = 0;
+
     virtual bool is_init(byte* ptr) const = 0;
 
     virtual gc_lifetime_tag get_lifetime_tag(byte* ptr) const = 0;
@@ -35,6 +62,10 @@ public:
     virtual void trace(byte* ptr, const gc_trace_callback& cb) const = 0;
     virtual void move(byte* to, byte* from, gc_memory_descriptor* from_descr) = 0;
     virtual void finalize(byte* ptr) = 0;
+
+    virtual size_t numa_node() const = 0;
+private:
+    gc_descriptor_kind m_kind;
 };
 
 }}}
@@ -0,0 +1,45 @@
+#ifndef ALLOCGC_GC_NURSERY_HPP
+#define ALLOCGC_GC_NURSERY_HPP
+
+#include <atomic>
+#include <cstddef>
+
+#include <liballocgc/details/utils/utility.hpp>
+
+namespace allocgc { namespace details { namespace allocators {
+
+/**
+ * Allocation budget of the young generation.
+ *
+ * Nursery is not a contiguous space: young chunks are taken by the pool allocators of the threads
+ * (one per size class) and are bump-allocated. The nursery bounds the memory of the young chunks handed out
+ * since the last collection, allocator which runs out of the budget triggers a minor collection.
+ */
+class gc_nursery : private utils::noncopyable, private utils::nonmovable
+{
+public:
+    static const size_t DEFAULT_SIZE;
+
+    explicit gc_nursery(size_t size = DEFAULT_SIZE);
+
+    /**
+     * Accounts the young chunk, returns false if the budget is exceeded.
+     * The first chunk after the collection always fits into the budget, so the nursery can not be smaller than one chunk.
+     */
+    bool reserve(size_t size);
+
+    // should be called after each collection, since young chunks are either released or survive it
+    void reset();
+
+    size_t size() const;
+    void set_size(size_t size);
+
+    size_t allocated() const;
+private:
+    std::atomic<size_t> m_size;
+    std::atomic<size_t> m_allocated;
+};
+
+}}}
+
+#endif //ALLOCGC_GC_NURSERY_HPP
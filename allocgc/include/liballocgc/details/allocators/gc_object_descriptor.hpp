@@ -1,6 +1,8 @@
 #ifndef ALLOCGC_GC_OBJECT_DESCRIPTOR_HPP
 #define ALLOCGC_GC_OBJECT_DESCRIPTOR_HPP
 
+#include <atomic>
+
 #include <liballocgc/gc_alloc.hpp>
 #include <liballocgc/details/utils/utility.hpp>
 #include <liballocgc/details/allocators/gc_memory_descriptor.hpp>
@@ -8,10 +10,10 @@
 
 namespace allocgc { namespace details { namespace allocators {
 
-class gc_object_descriptor : public gc_memory_descriptor, private utils::noncopyable, private utils::nonmovable
+class gc_object_descriptor final : public gc_memory_descriptor, private utils::noncopyable, private utils::nonmovable
 {
 public:
-    gc_object_descriptor(size_t size);
+    gc_object_descriptor(size_t size, size_t numa_node);
     ~gc_object_descriptor();
 
     gc_memory_descriptor* descriptor();
@@ -30,6 +32,8 @@ public:
     void set_mark(byte* ptr, bool mark) override;
     void set_pin(byte* ptr, bool pin) override;
 
+    bool try_mark(byte* ptr) override;
+
     bool is_init(byte* ptr) const override;
 
     gc_lifetime_tag get_lifetime_tag(byte* ptr) const override;
@@ -50,11 +54,14 @@ public:
     void trace(byte* ptr, const gc_trace_callback& cb) const override;
     void move(byte* to, byte* from, gc_memory_descriptor* from_descr) override;
     void finalize(byte* ptr) override;
+
+    size_t numa_node() const override;
 private:
     bool check_ptr(byte* ptr) const;
 
     size_t m_size;
-    bool   m_mark_bit;
+    size_t m_numa_node;
+    std::atomic<bool> m_mark_bit;
     bool   m_pin_bit;
     bool   m_init_bit;
 };
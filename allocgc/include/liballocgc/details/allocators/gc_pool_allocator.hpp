@@ -2,6 +2,7 @@
 #define ALLOCGC_GC_POOL_ALLOCATOR_HPP
 
 #include <list>
+#include <vector>
 #include <cstring>
 #include <utility>
 
@@ -9,9 +10,12 @@
 #include <liballocgc/details/allocators/gc_pool_descriptor.hpp>
 #include <liballocgc/details/allocators/default_allocator.hpp>
 #include <liballocgc/details/allocators/gc_core_allocator.hpp>
+#include <liballocgc/details/allocators/gc_nursery.hpp>
 #include <liballocgc/details/allocators/allocator_tag.hpp>
 #include <liballocgc/details/allocators/stl_adapter.hpp>
 
+#include <liballocgc/details/gc_cell.hpp>
+
 #include <liballocgc/details/utils/flatten_range.hpp>
 #include <liballocgc/details/utils/utility.hpp>
 
@@ -44,12 +48,58 @@ public:
     gc_core_allocator* get_core_allocator() const;
     void set_core_allocator(gc_core_allocator* core_alloc);
 
+    size_t get_numa_node() const;
+    void set_numa_node(size_t numa_node);
+
+    // new chunks are allocated within the budget of the nursery (if any)
+    gc_nursery* get_nursery() const;
+    void set_nursery(gc_nursery* nursery);
+
+    // young allocator allocates young chunks, its survivors are evacuated into the old one
+    bool is_young() const;
+    void set_young(bool young);
+
     gc_alloc::response allocate(const gc_alloc::request& rqst, size_t aligned_size);
 
     gc_collect_stat collect(compacting::forwarding& frwd);
     void fix(const compacting::forwarding& frwd);
     void finalize();
 
+    /**
+     * Minor collection of the sticky mark bits mode: unmarked cells of the fresh chunks are young garbage,
+     * they are finalized and put into the freelist. Other cells and the chunks allocated from before the last collection
+     * are not touched, mark bits are kept, so the survivors become old.
+     */
+    gc_collect_stat sweep_fresh();
+
+    /**
+     * Local collection of the thread-local heap: unmarked local cells of the fresh chunks are finalized
+     * and put into the freelist, marks of the local survivors are cleared, so they stay local.
+     * Shared cells are collected only by the global collection, which also clears the fresh flags,
+     * thus the local garbage of the chunks swept by it waits for the next global collection.
+     */
+    gc_collect_stat sweep_local();
+    void unpin();
+
+    /**
+     * Moves the live unpinned cells of the young chunks into the old allocator of the same size class.
+     * Pinned survivors and the ones which do not fit into the old generation are left in place.
+     */
+    gc_collect_stat evacuate(gc_pool_allocator& old_gen, compacting::forwarding& frwd);
+
+    /**
+     * Fixes the pointers of the survivors of the last evacuation, i.e. of the cells promoted into the old allocator
+     * or of the pinned cells left in the young one. Promoted cells are unmarked,
+     * and their slots which still point to the nursery are appended to young_slots.
+     */
+    void fix_survivors(const compacting::forwarding& frwd, std::vector<gc_handle*>& young_slots);
+
+    // returns evacuated young chunks to the core allocator, garbage of the chunks with survivors goes to the freelist
+    gc_collect_stat release_evacuated();
+
+    // calls the callback for each live (i.e. marked and initialized) cell
+    void trace_live(const gc_cell_callback& cb);
+
     gc_memstat stats();
 
     bool empty() const;
@@ -60,16 +110,24 @@ private:
     static constexpr double RESIDENCY_NON_COMPACTING_THRESHOLD = 0.9;
     static constexpr double RESIDENCY_EPS = 0.1;
 
+    // number of free chunks kept by allocator instead of returning them to core allocator,
+    // the cache is flushed by the next collection of the allocator
+    static const size_t CHUNK_CACHE_SIZE = 4;
+
     gc_alloc::response try_expand_and_allocate(size_t size, const gc_alloc::request& rqst, size_t attempt_num);
     gc_alloc::response stack_allocation(size_t size, const gc_alloc::request& rqst);
     gc_alloc::response freelist_allocation(size_t size, const gc_alloc::request& rqst);
     gc_alloc::response init_cell(byte* cell_start, const gc_alloc::request& rqst, descriptor_t* descr);
 
+    // allocates the cell for the promoted object during the pause, returns null cell if the heap is exhausted
+    gc_cell allocate_promoted(size_t size);
+
     gc_pool_allocator::iterator_t create_descriptor(byte* blk, size_t blk_size, size_t cell_size);
     iterator_t destroy_descriptor(iterator_t it);
 
     std::pair<byte*, size_t> allocate_block(size_t cell_size);
     void deallocate_block(byte* ptr, size_t size);
+    void flush_chunk_cache();
 
     bool contains(byte* ptr) const;
 
@@ -84,11 +142,21 @@ private:
 
     void insert_into_freelist(byte* ptr);
 
+    // finalizes the garbage cell of the chunk and pushes it into the freelist
+    void free_cell(descriptor_t& descr, size_t idx, byte* cell);
+
     gc_core_allocator* m_core_alloc;
+    size_t m_numa_node;
+    gc_nursery* m_nursery;
+    bool m_young;
     descriptor_list_t m_descrs;
+    // cells promoted into the old allocator or pinned cells left in the young one by the last evacuation
+    std::vector<gc_cell> m_survivors;
     byte** m_freelist;
     byte*  m_top;
     byte*  m_end;
+    byte** m_chunk_cache;
+    size_t m_chunk_cache_size;
     double m_prev_residency;
 };
 
@@ -15,11 +15,12 @@
 #include <liballocgc/details/utils/bitset.hpp>
 #include <liballocgc/details/utils/utility.hpp>
 #include <liballocgc/details/allocators/gc_memory_descriptor.hpp>
+#include <liballocgc/details/allocators/mark_bitmap.hpp>
 #include <liballocgc/details/constants.hpp>
 
 namespace allocgc { namespace details { namespace allocators {
 
-class gc_pool_descriptor : public gc_memory_descriptor, private utils::noncopyable, private utils::nonmovable
+class gc_pool_descriptor final : public gc_memory_descriptor, private utils::noncopyable, private utils::nonmovable
 {
 public:
     static const size_t CHUNK_MAXSIZE = MANAGED_CHUNK_OBJECTS_COUNT;
@@ -86,9 +87,29 @@ public:
         return cell_size * CHUNK_MAXSIZE;
     }
 
-    gc_pool_descriptor(byte* chunk, size_t size, size_t cell_size);
+    gc_pool_descriptor(byte* chunk, size_t size, size_t cell_size, size_t numa_node = 0, bool young = false);
     ~gc_pool_descriptor();
 
+    // returns true if the cell belongs to the young chunk, i.e. to the nursery of the generational collector
+    static inline bool is_young_cell(const gc_cell& cell)
+    {
+        return cell.descriptor() && cell.descriptor()->kind() == gc_descriptor_kind::POOL
+               && static_cast<const gc_pool_descriptor*>(cell.descriptor())->is_young();
+    }
+
+    static bool is_young_ptr(byte* ptr);
+
+    // returns true if the cell is reachable from the threads other than the owner of its thread-local heap;
+    // unlike the mark bit the shared bit survives the collections, cells of large objects are always shared
+    static inline bool is_shared_cell(const gc_cell& cell)
+    {
+        if (!cell.descriptor() || cell.descriptor()->kind() != gc_descriptor_kind::POOL) {
+            return true;
+        }
+        const gc_pool_descriptor* descr = static_cast<const gc_pool_descriptor*>(cell.descriptor());
+        return descr->is_shared((cell.cell_start() - descr->m_memory) >> descr->m_cell_size_log2);
+    }
+
     gc_memory_descriptor* descriptor()
     {
         return this;
@@ -98,23 +119,34 @@ public:
     {
         assert(contains(ptr));
         assert(ptr == cell_start(ptr));
+        m_shared_bits.set((ptr - m_memory) >> m_cell_size_log2, false);
         return gc_box::create(ptr, obj_count, type_meta);
     }
 
     inline bool unused() const
     {
-        return m_mark_bits.none();
+        return count_lived() == 0;
     }
 
     inline void unmark()
     {
-        m_mark_bits.reset_all();
+        if (m_heap_marks) {
+            m_heap_marks->reset(m_memory, m_size);
+        } else {
+            m_mark_bits.reset_all();
+        }
+        m_pin_bits.reset_all();
+    }
+
+    // pins are reset after each collection, while mark bits of the old cells are kept in the sticky mark bits mode
+    inline void unpin()
+    {
         m_pin_bits.reset_all();
     }
 
     size_t count_lived() const
     {
-        return m_mark_bits.count();
+        return m_heap_marks ? m_heap_marks->count(m_memory, m_size) : m_mark_bits.count();
     }
 
     size_t count_pinned() const
@@ -135,8 +167,13 @@ public:
     void set_mark(byte* ptr, bool mark) override;
     void set_pin(byte* ptr, bool pin) override;
 
+    bool try_mark(byte* ptr) override;
+
     bool is_init(byte* ptr) const override;
 
+    bool is_shared(byte* ptr) const;
+    void set_shared(byte* ptr, bool shared);
+
     gc_lifetime_tag get_lifetime_tag(size_t idx) const;
     gc_lifetime_tag get_lifetime_tag(byte* ptr) const override;
 
@@ -160,9 +197,11 @@ public:
     void finalize(size_t i);
     void finalize(byte* ptr) override;
 
+    size_t numa_node() const override;
+
     inline bool get_mark(size_t idx) const
     {
-        return m_mark_bits.get(idx);
+        return m_heap_marks ? m_heap_marks->get(cell_at(idx)) : m_mark_bits.get(idx);
     }
 
     inline bool get_pin(size_t idx) const
@@ -175,9 +214,26 @@ public:
         return m_init_bits.get(idx);
     }
 
+    inline bool is_shared(size_t idx) const
+    {
+        return m_shared_bits.get(idx);
+    }
+
     inline void set_mark(size_t idx, bool mark)
     {
-        m_mark_bits.set(idx, mark);
+        if (m_heap_marks) {
+            m_heap_marks->set(cell_at(idx), mark);
+        } else {
+            m_mark_bits.set(idx, mark);
+        }
+    }
+
+    inline bool try_mark(size_t idx)
+    {
+        if (m_heap_marks) {
+            return !m_heap_marks->test_and_set(cell_at(idx));
+        }
+        return !m_mark_bits.get(idx) && !m_mark_bits.test_and_set(idx);
     }
 
     inline void set_pin(size_t idx, bool pin)
@@ -185,6 +241,17 @@ public:
         m_pin_bits.set(idx, pin);
     }
 
+    inline void set_init(size_t idx, bool init)
+    {
+        m_init_bits.set(idx, init);
+    }
+
+    // shared bits are changed only by the owner of the chunk
+    inline void set_shared(size_t idx, bool shared)
+    {
+        m_shared_bits.set(idx, shared);
+    }
+
     inline byte* memory() const
     {
         return m_memory;
@@ -195,24 +262,46 @@ public:
         return m_size;
     }
 
+    inline bool is_young() const
+    {
+        return m_young;
+    }
+
+    // chunk is fresh if some of its cells were allocated since the last collection
+    inline bool is_fresh() const
+    {
+        return m_fresh;
+    }
+
+    inline void set_fresh(bool fresh)
+    {
+        m_fresh = fresh;
+    }
+
     bool contains(byte* ptr) const;
 
     size_t mem_used();
 private:
     void set_init(byte* ptr, bool init);
 
-    inline void set_init(size_t idx, bool init)
+    size_t calc_cell_ind(byte* ptr) const;
+
+    inline byte* cell_at(size_t idx) const
     {
-        m_init_bits.set(idx, init);
+        return m_memory + (idx << m_cell_size_log2);
     }
 
-    size_t calc_cell_ind(byte* ptr) const;
-
     byte*         m_memory;
     size_t        m_size;
     size_t        m_cell_size_log2;
+    size_t        m_numa_node;
+    bool          m_young;
+    bool          m_fresh;
     bitset_t      m_pin_bits;
     bitset_t      m_init_bits;
+    bitset_t      m_shared_bits;
+    // mark bits of the chunks of the reserved heap range are kept in the heap-wide bitmap
+    mark_bitmap*  m_heap_marks;
     sync_bitset_t m_mark_bits;
 };
 
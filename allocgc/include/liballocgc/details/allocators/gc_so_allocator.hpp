@@ -28,7 +28,8 @@ public:
     typedef stateful_alloc_tag alloc_tag;
     typedef utils::static_thread_pool thread_pool_t;
 
-    explicit gc_so_allocator(gc_core_allocator* core_alloc);
+    // new chunks are allocated within the budget of the nursery (if any), young allocator serves the young generation
+    gc_so_allocator(gc_core_allocator* core_alloc, size_t numa_node, gc_nursery* nursery = nullptr, bool young = false);
 
     gc_alloc::response allocate(const gc_alloc::request& rqst);
 
@@ -36,6 +37,22 @@ public:
     void fix(const compacting::forwarding& frwd, thread_pool_t& thread_pool);
     void finalize();
 
+    // evacuation of the young allocator into the old one, see gc_pool_allocator
+    gc_collect_stat evacuate(gc_so_allocator& old_gen, compacting::forwarding& frwd, thread_pool_t& thread_pool);
+    void fix_survivors(const compacting::forwarding& frwd, thread_pool_t& thread_pool, std::vector<gc_handle*>& young_slots);
+    gc_collect_stat release_evacuated();
+
+    // minor collection of the sticky mark bits mode, see gc_pool_allocator
+    gc_collect_stat sweep_fresh(thread_pool_t& thread_pool);
+    // local collection of the thread-local heap, see gc_pool_allocator
+    gc_collect_stat sweep_local(thread_pool_t& thread_pool);
+    void unpin();
+
+    // allocation budget shared by all the buckets, null if the chunks are allocated without the budget
+    gc_nursery* nursery() const;
+
+    void trace_live(const gc_cell_callback& cb);
+
     gc_memstat stats();
 private:
     // we have buckets for each 2^k size
@@ -9,13 +9,14 @@
 #include <iterator>
 #include <memory>
 #include <limits>
+#include <algorithm>
 
 #include <boost/integer/static_min_max.hpp>
 
 #include <liballocgc/gc_common.hpp>
 #include <liballocgc/details/constants.hpp>
 #include <liballocgc/details/utils/utility.hpp>
-#include <liballocgc/details/allocators/pool.hpp>
+#include <liballocgc/details/allocators/lock_free_pool.hpp>
 #include <liballocgc/details/allocators/memory_descriptor.hpp>
 
 namespace allocgc { namespace details { namespace allocators {
@@ -86,18 +87,30 @@ public:
         init_impl();
     }
 
+    // makes memory of the removed levels available for reuse;
+    // should be called when no thread accesses any index tree, e.g. during stop-the-world pause
+    static void reclaim()
+    {
+        level_factory<second_level_t>::instance().reclaim();
+        level_factory<third_level_t>::instance().reclaim();
+    }
+
     void clear()
     {
         clear_impl();
     }
 
+    // indexes memory by runs of pages sharing the same last level,
+    // i.e. tree is descended once per run and not once per page
     void index(const byte* mem, size_t size, memory_descriptor descriptor)
     {
         assert(reinterpret_cast<std::uintptr_t>(mem) % PAGE_SIZE == 0);
 //        assert(size % PAGE_SIZE == 0);
         const byte* mem_end = mem + size;
-        for (const byte* it = mem; it < mem_end; it += PAGE_SIZE) {
-            add_page_to_index(it, descriptor);
+        for (const byte* it = mem; it < mem_end; ) {
+            size_t cnt = pages_run_count(it, mem_end);
+            add_pages_to_index(it, cnt, descriptor);
+            it += cnt * PAGE_SIZE;
         }
     }
 
@@ -106,8 +119,10 @@ public:
         assert(reinterpret_cast<std::uintptr_t>(mem) % PAGE_SIZE == 0);
 //        assert(size % PAGE_SIZE == 0);
         const byte* mem_end = mem + size;
-        for (const byte* it = mem; it < mem_end; it += PAGE_SIZE) {
-            remove_page_from_index(it);
+        for (const byte* it = mem; it < mem_end; ) {
+            size_t cnt = pages_run_count(it, mem_end);
+            remove_pages_from_index(it, cnt);
+            it += cnt * PAGE_SIZE;
         }
     }
 
@@ -147,15 +162,28 @@ private:
         template <typename... Args>
         std::unique_ptr<Level, level_deleter> create(Args&&... args)
         {
-            return std::unique_ptr<Level, level_deleter>(m_pool.create(std::forward<Args>(args)...));
+            byte* ptr = m_pool.allocate();
+            new (ptr) Level(std::forward<Args>(args)...);
+            return std::unique_ptr<Level, level_deleter>(reinterpret_cast<Level*>(ptr));
         }
 
+        // concurrent readers can still walk through the level, so its memory is reused only after reclaim()
         void destroy(Level* level)
         {
-            m_pool.destroy(level);
+            level->~Level();
+            m_pool.retire(reinterpret_cast<byte*>(level));
+        }
+
+        void reclaim()
+        {
+            m_pool.reclaim();
         }
     private:
-        allocators::pool<Level, std::mutex> m_pool;
+        level_factory()
+            : m_pool(sizeof(Level))
+        {}
+
+        lock_free_pool m_pool;
     };
 
     template <typename Level>
@@ -174,33 +202,34 @@ private:
             : m_data(other.m_data)
         {}
 
-        void index(idxs_t::iterator idx, memory_descriptor entry)
+        // cnt is a number of consecutive pages, all of them should belong to the same last level
+        void index(idxs_t::iterator idx, size_t cnt, memory_descriptor entry)
         {
             idxs_t::iterator next_idx = std::next(idx);
 
-            m_data[*idx].m_cnt.fetch_add(1, std::memory_order_acq_rel);
+            m_data[*idx].m_cnt.fetch_add(cnt, std::memory_order_acq_rel);
 
             Level* next_level = m_data[*idx].m_ptr.load(std::memory_order_acquire);
             if (next_level == null()) {
                 auto new_level = level_factory<Level>::instance().create(*null());
-                new_level->index(next_idx, entry);
+                new_level->index(next_idx, cnt, entry);
                 if (m_data[*idx].m_ptr.compare_exchange_strong(next_level, new_level.get(), std::memory_order_acq_rel)) {
                     new_level.release();
                 } else {
-                    next_level->index(next_idx, entry);
+                    next_level->index(next_idx, cnt, entry);
                 }
             } else {
-                next_level->index(next_idx, entry);
+                next_level->index(next_idx, cnt, entry);
             }
         }
 
-        void remove_index(idxs_t::iterator idx)
+        void remove_index(idxs_t::iterator idx, size_t cnt)
         {
             idxs_t::iterator next_idx = std::next(idx);
 
             Level* next_level = m_data[*idx].m_ptr.load(std::memory_order_acquire);
-            next_level->remove_index(next_idx);
-            if (m_data[*idx].m_cnt.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            next_level->remove_index(next_idx, cnt);
+            if (m_data[*idx].m_cnt.fetch_sub(cnt, std::memory_order_acq_rel) == cnt) {
                 m_data[*idx].m_ptr.store(null(), std::memory_order_release);
                 level_factory<Level>::instance().destroy(next_level);
             }
@@ -289,16 +318,22 @@ private:
             : m_data(other.m_data)
         {}
 
-        void index(idxs_t::iterator idx, memory_descriptor descriptor)
+        void index(idxs_t::iterator idx, size_t cnt, memory_descriptor descriptor)
         {
-            assert(!m_data[*idx].m_ptr.load(std::memory_order_acquire));
-            m_data[*idx].m_ptr.store(descriptor, std::memory_order_release);
+            assert(*idx + cnt <= LEVEL_SIZE);
+            for (size_t i = *idx; i < *idx + cnt; ++i) {
+                assert(!m_data[i].m_ptr.load(std::memory_order_acquire));
+                m_data[i].m_ptr.store(descriptor, std::memory_order_release);
+            }
         }
 
-        void remove_index(idxs_t::iterator idx)
+        void remove_index(idxs_t::iterator idx, size_t cnt)
         {
-            assert(m_data[*idx].m_ptr.load(std::memory_order_acquire));
-            m_data[*idx].m_ptr.store(nullptr, std::memory_order_release);
+            assert(*idx + cnt <= LEVEL_SIZE);
+            for (size_t i = *idx; i < *idx + cnt; ++i) {
+                assert(m_data[i].m_ptr.load(std::memory_order_acquire));
+                m_data[i].m_ptr.store(nullptr, std::memory_order_release);
+            }
         }
 
         memory_descriptor get(idxs_t::iterator idx) const
@@ -347,16 +382,25 @@ private:
         level_factory<third_level_t>::instance();
     }
 
-    void add_page_to_index(const byte* page, memory_descriptor entry)
+    // number of pages in [page, mem_end) which belong to the same last level as the page
+    static size_t pages_run_count(const byte* page, const byte* mem_end)
+    {
+        idxs_t idxs = internals::splitter::split(page);
+        size_t level_rest = third_level_t::LEVEL_SIZE - idxs.back();
+        size_t mem_rest   = (mem_end - page + PAGE_SIZE - 1) / PAGE_SIZE;
+        return std::min(level_rest, mem_rest);
+    }
+
+    void add_pages_to_index(const byte* page, size_t cnt, memory_descriptor entry)
     {
         idxs_t idxs = internals::splitter::split(page);
-        m_first_level.index(idxs.begin(), entry);
+        m_first_level.index(idxs.begin(), cnt, entry);
     }
 
-    void remove_page_from_index(const byte* page)
+    void remove_pages_from_index(const byte* page, size_t cnt)
     {
         idxs_t idxs = internals::splitter::split(page);
-        m_first_level.remove_index(idxs.begin());
+        m_first_level.remove_index(idxs.begin(), cnt);
     }
 
     memory_descriptor index_page(const byte* page) const
@@ -136,13 +136,16 @@ public:
         assert(empty());
     }
 
-    byte* allocate(size_t size)
+    // extra arguments (e.g. NUMA node) are passed to the upstream allocator,
+    // the block should be deallocated with the same arguments
+    template <typename... Args>
+    byte* allocate(size_t size, const Args&... args)
     {
         size_t blk_size = get_blk_size(size);
-        auto deleter = [this, blk_size] (byte* p) {
-            upstream_deallocate(p, blk_size);
+        auto deleter = [this, blk_size, &args...] (byte* p) {
+            upstream_deallocate(p, blk_size, args...);
         };
-        std::unique_ptr<byte, decltype(deleter)> blk(upstream_allocate(blk_size), deleter);
+        std::unique_ptr<byte, decltype(deleter)> blk(upstream_allocate(blk_size, args...), deleter);
 
         if (!blk) {
             return nullptr;
@@ -166,7 +169,8 @@ public:
         return get_memblk(blk.release());
     }
 
-    void deallocate(byte* ptr, size_t size)
+    template <typename... Args>
+    void deallocate(byte* ptr, size_t size, const Args&... args)
     {
         std::unique_lock<Lock> lock(m_lock);
 
@@ -179,7 +183,7 @@ public:
 
         lock.unlock();
 
-        upstream_deallocate(get_blk_by_cblk(cblk), get_blk_size(size));
+        upstream_deallocate(get_blk_by_cblk(cblk), get_blk_size(size), args...);
     }
 
     bool empty() const
@@ -229,14 +233,16 @@ private:
         return &m_fake;
     }
 
-    byte* upstream_allocate(size_t size)
+    template <typename... Args>
+    byte* upstream_allocate(size_t size, const Args&... args)
     {
-        return UpstreamAlloc::allocate(size);
+        return UpstreamAlloc::allocate(size, args...);
     }
 
-    void upstream_deallocate(byte* ptr, size_t size)
+    template <typename... Args>
+    void upstream_deallocate(byte* ptr, size_t size, const Args&... args)
     {
-        UpstreamAlloc::deallocate(ptr, size);
+        UpstreamAlloc::deallocate(ptr, size, args...);
     }
 
     control_block  m_fake;
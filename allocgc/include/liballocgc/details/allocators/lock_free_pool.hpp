@@ -0,0 +1,60 @@
+#ifndef ALLOCGC_LOCK_FREE_POOL_HPP
+#define ALLOCGC_LOCK_FREE_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+#include <liballocgc/gc_common.hpp>
+#include <liballocgc/details/utils/utility.hpp>
+
+namespace allocgc { namespace details { namespace allocators {
+
+/**
+ * Lock-free pool of fixed size objects.
+ *
+ * Objects are carved out of a pre-reserved region of virtual memory by atomic bump of the top pointer.
+ * Freed objects are not reused immediately, since concurrent readers still can access them;
+ * they are retired and moved to the free list only by reclaim(),
+ * which should be called when no thread can hold a pointer to a retired object (e.g. during stop-the-world pause).
+ *
+ * The pool never returns memory to the OS, so it can be safely used by static objects during destruction.
+ */
+class lock_free_pool : private utils::noncopyable, private utils::nonmovable
+{
+public:
+    static const size_t DEFAULT_RESERVE_SIZE;
+
+    explicit lock_free_pool(size_t obj_size, size_t reserve_size = DEFAULT_RESERVE_SIZE);
+
+    byte* allocate();
+
+    // defers reuse of the object until the next reclaim()
+    void retire(byte* ptr);
+
+    void reclaim();
+private:
+    // head of the free list keeps ABA counter in the high bits of the pointer
+    typedef std::uintptr_t tagged_ptr_t;
+
+    static byte* get_ptr(tagged_ptr_t head);
+    static tagged_ptr_t make_tagged(byte* ptr, tagged_ptr_t prev_head);
+
+    static byte*& next(byte* ptr)
+    {
+        return *reinterpret_cast<byte**>(ptr);
+    }
+
+    byte* pop_free();
+
+    size_t m_obj_size;
+    byte*  m_base;
+    size_t m_size;
+    std::atomic<size_t>       m_top;
+    std::atomic<tagged_ptr_t> m_free;
+    std::atomic<byte*>        m_retired;
+};
+
+}}}
+
+#endif //ALLOCGC_LOCK_FREE_POOL_HPP
@@ -0,0 +1,101 @@
+#ifndef ALLOCGC_MARK_BITMAP_HPP
+#define ALLOCGC_MARK_BITMAP_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+
+#include <liballocgc/details/utils/utility.hpp>
+#include <liballocgc/details/constants.hpp>
+#include <liballocgc/gc_common.hpp>
+
+namespace allocgc { namespace details { namespace allocators {
+
+/**
+ * Heap-wide bitmap of mark bits for a contiguous range of memory, one bit per MIN_CELL_SIZE bytes.
+ * Bit of a cell is found by (ptr - base) >> MIN_CELL_SIZE_LOG2, so mark bits of neighbouring cells
+ * share cache lines regardless of where the descriptors of their chunks are allocated.
+ *
+ * Only the bits of cell starts are ever set, thus the number of marked cells in the range
+ * is the population count of its bits.
+ *
+ * Like the page table, bitmap memory is committed lazily and is never released.
+ */
+class mark_bitmap : private utils::noncopyable, private utils::nonmovable
+{
+    typedef std::atomic<std::uint64_t> word_t;
+public:
+    constexpr mark_bitmap()
+        : m_base(0)
+        , m_size(0)
+        , m_bits(nullptr)
+    {}
+
+    // can be called only once, before any memory of the range is used
+    void init(const byte* base, size_t size);
+
+    inline bool contains(const byte* mem) const
+    {
+        return reinterpret_cast<std::uintptr_t>(mem) - m_base < m_size;
+    }
+
+    inline bool get(const byte* ptr) const
+    {
+        size_t idx = bit_idx(ptr);
+        return m_bits[word_idx(idx)].load(std::memory_order_relaxed) & bit_mask(idx);
+    }
+
+    inline void set(const byte* ptr, bool mark)
+    {
+        size_t idx = bit_idx(ptr);
+        if (mark) {
+            m_bits[word_idx(idx)].fetch_or(bit_mask(idx), std::memory_order_relaxed);
+        } else {
+            m_bits[word_idx(idx)].fetch_and(~bit_mask(idx), std::memory_order_relaxed);
+        }
+    }
+
+    // sets the bit in one atomic operation and returns its previous value
+    inline bool test_and_set(const byte* ptr)
+    {
+        size_t idx = bit_idx(ptr);
+        std::uint64_t mask = bit_mask(idx);
+        word_t& word = m_bits[word_idx(idx)];
+        // cheap check first, so that the cache line of the marked cell is not taken exclusively
+        if (word.load(std::memory_order_relaxed) & mask) {
+            return true;
+        }
+        return word.fetch_or(mask, std::memory_order_relaxed) & mask;
+    }
+
+    // range should be aligned by WORD_BITS * MIN_CELL_SIZE bytes
+    void reset(const byte* mem, size_t size);
+    size_t count(const byte* mem, size_t size) const;
+private:
+    static const size_t WORD_BITS = 64;
+
+    inline size_t bit_idx(const byte* ptr) const
+    {
+        assert(contains(ptr));
+        return (reinterpret_cast<std::uintptr_t>(ptr) - m_base) >> MIN_CELL_SIZE_LOG2;
+    }
+
+    static inline size_t word_idx(size_t bit_idx)
+    {
+        return bit_idx / WORD_BITS;
+    }
+
+    static inline std::uint64_t bit_mask(size_t bit_idx)
+    {
+        return (std::uint64_t) 1 << (bit_idx % WORD_BITS);
+    }
+
+    std::uintptr_t m_base;
+    size_t         m_size;
+    word_t*        m_bits;
+};
+
+}}}
+
+#endif //ALLOCGC_MARK_BITMAP_HPP
@@ -1,11 +1,22 @@
 #ifndef ALLOCGC_MEMORY_DESCRIPTOR_HPP
 #define ALLOCGC_MEMORY_DESCRIPTOR_HPP
 
+#include <cassert>
+#include <cstdint>
+
 #include <liballocgc/gc_common.hpp>
+#include <liballocgc/details/constants.hpp>
 #include <liballocgc/details/allocators/gc_memory_descriptor.hpp>
 
 namespace allocgc { namespace details { namespace allocators {
 
+/**
+ * Entry of the memory index.
+ *
+ * Entries of pool chunks also keep log2 of the chunk's cell size in the unused high bits of the pointer.
+ * Chunks are page-aligned and their cells are not larger than a page,
+ * thus start of the cell can be found by masking an internal pointer, without calling the descriptor.
+ */
 class memory_descriptor
 {
 public:
@@ -33,6 +44,13 @@ public:
         return memory_descriptor(reinterpret_cast<std::uintptr_t>(descriptor));
     }
 
+    static memory_descriptor make_gc_pool_descriptor(gc_memory_descriptor* descriptor, size_t cell_size_log2)
+    {
+        assert(cell_size_log2 > 0 && cell_size_log2 <= PAGE_SIZE_LOG2);
+        assert((reinterpret_cast<std::uintptr_t>(descriptor) & ~POINTER_MASK) == 0);
+        return memory_descriptor(reinterpret_cast<std::uintptr_t>(descriptor) | (cell_size_log2 << CELL_SIZE_SHIFT));
+    }
+
     inline bool is_null() const
     {
         return m_descriptor == 0;
@@ -48,6 +66,18 @@ public:
         return !is_null() && !is_stack_descriptor();
     }
 
+    inline bool is_gc_pool_descriptor() const
+    {
+        return m_descriptor & ~POINTER_MASK;
+    }
+
+    inline byte* cell_start(byte* ptr) const
+    {
+        assert(is_gc_pool_descriptor());
+        std::uintptr_t cell_size_log2 = m_descriptor >> CELL_SIZE_SHIFT;
+        return reinterpret_cast<byte*>(reinterpret_cast<std::uintptr_t>(ptr) & ~((1ull << cell_size_log2) - 1));
+    }
+
     byte* to_stack_descriptor() const
     {
         assert(is_stack_descriptor());
@@ -57,7 +87,7 @@ public:
     gc_memory_descriptor* to_gc_descriptor() const
     {
         assert(is_gc_heap_descriptor());
-        return reinterpret_cast<gc_memory_descriptor*>(m_descriptor);
+        return reinterpret_cast<gc_memory_descriptor*>(m_descriptor & POINTER_MASK);
     }
 
     explicit operator bool() const
@@ -68,6 +98,9 @@ private:
     static const std::uintptr_t STACK_TAG = 1;
     static const std::uintptr_t GC_HEAP_TAG = 0;
 
+    static const size_t         CELL_SIZE_SHIFT = POINTER_BITS_USED;
+    static const std::uintptr_t POINTER_MASK    = ((std::uintptr_t) 1 << POINTER_BITS_USED) - 1;
+
     explicit inline constexpr memory_descriptor(std::uintptr_t descriptor)
         : m_descriptor(reinterpret_cast<std::uintptr_t>(descriptor))
     {}
@@ -1,19 +1,53 @@
 #ifndef ALLOCGC_MEMORY_INDEX_HPP
 #define ALLOCGC_MEMORY_INDEX_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
 #include <liballocgc/details/allocators/index_tree.hpp>
+#include <liballocgc/details/allocators/page_table.hpp>
+#include <liballocgc/details/allocators/mark_bitmap.hpp>
+#include <liballocgc/details/allocators/card_table.hpp>
+#include <liballocgc/details/allocators/reserved_range_allocator.hpp>
 #include <liballocgc/details/allocators/memory_descriptor.hpp>
 #include <liballocgc/details/allocators/gc_memory_descriptor.hpp>
 #include <liballocgc/details/gc_cell.hpp>
 
 namespace allocgc { namespace details { namespace allocators {
 
+/**
+ * Memory of the reserved heap range is indexed by the flat page table,
+ * all other memory (stacks, heap memory allocated after the reserved range is exhausted) is indexed by the tree.
+ *
+ * Mark bits of the pool cells of the reserved range are kept in the heap-wide mark bitmap,
+ * and stores into the reserved range are tracked by the heap card table.
+ */
 class memory_index
 {
 public:
     static inline void init()
     {
         indexer.init();
+        // reserve heap range and initialize the page table
+        reserved_range_allocator::reserved_range();
+    }
+
+    static inline void init_page_table(const byte* heap_base, size_t heap_size)
+    {
+        heap_table.init(heap_base, heap_size);
+        heap_marks.init(heap_base, heap_size);
+        heap_cards.init(heap_base, heap_size);
+    }
+
+    static inline mark_bitmap& heap_mark_bitmap()
+    {
+        return heap_marks;
+    }
+
+    static inline card_table& heap_card_table()
+    {
+        return heap_cards;
     }
 
     static inline void clear()
@@ -21,39 +55,116 @@ public:
         indexer.clear();
     }
 
+    static inline void reclaim()
+    {
+        index_tree::reclaim();
+    }
+
     static inline void index_stack_memory(const byte* mem, size_t size, byte* descriptor)
     {
-        indexer.index(mem, size, memory_descriptor::make_stack_descriptor(descriptor));
+        index(mem, size, memory_descriptor::make_stack_descriptor(descriptor));
     }
 
     static inline void index_gc_heap_memory(const byte* mem, size_t size, gc_memory_descriptor* descriptor)
     {
-        indexer.index(mem, size, memory_descriptor::make_gc_heap_descriptor(descriptor));
+        index(mem, size, memory_descriptor::make_gc_heap_descriptor(descriptor));
+    }
+
+    static inline void index_gc_pool_memory(const byte* mem, size_t size, gc_memory_descriptor* descriptor,
+                                            size_t cell_size_log2)
+    {
+        index(mem, size, memory_descriptor::make_gc_pool_descriptor(descriptor, cell_size_log2));
     }
 
     static inline void deindex(const byte* mem, size_t size)
     {
-        indexer.deindex(mem, size);
+        if (heap_table.contains(mem)) {
+            heap_table.deindex(mem, size);
+        } else {
+            indexer.deindex(mem, size);
+        }
     }
 
     static inline memory_descriptor get_descriptor(const byte* mem)
     {
+        if (heap_table.contains(mem)) {
+            return heap_table.get_descriptor(mem);
+        }
         return indexer.get_descriptor(mem);
     }
 
     static inline gc_cell get_gc_cell(byte* ptr)
     {
-        return gc_cell::from_internal_ptr(ptr, get_descriptor(ptr).to_gc_descriptor());
+        memory_descriptor descriptor = get_descriptor(ptr);
+        if (descriptor.is_gc_pool_descriptor()) {
+            return gc_cell::from_cell_start(descriptor.cell_start(ptr), descriptor.to_gc_descriptor());
+        }
+        return gc_cell::from_internal_ptr(ptr, descriptor.to_gc_descriptor());
     }
 
     static inline size_t size()
     {
-        return indexer.size();
+        return indexer.size() + heap_table.size();
+    }
+
+    // returns true if some gc heap memory has been indexed outside of the reserved range, i.e. not covered by the cards
+    static inline bool heap_overflowed()
+    {
+        return heap_overflow.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Cleans the dirty cards of the heap card table and calls f(cell) for each cell of the gc heap lying on them.
+     * Cell spanning several dirty cards is visited only once.
+     */
+    template <typename Functor>
+    static void clean_cards(Functor&& f)
+    {
+        byte* visited_end = nullptr;
+        heap_cards.clean([&f, &visited_end] (byte* card_begin, byte* card_end) {
+            byte* ptr = std::max(card_begin, visited_end);
+            while (ptr < card_end) {
+                byte* next_page = reinterpret_cast<byte*>(
+                        (reinterpret_cast<std::uintptr_t>(ptr) & ~(PAGE_SIZE - 1)) + PAGE_SIZE
+                );
+                if (!get_descriptor(ptr).is_gc_heap_descriptor()) {
+                    ptr = next_page;
+                    continue;
+                }
+                gc_cell cell = get_gc_cell(ptr);
+                byte* cell_end = cell.cell_start() + cell.cell_size();
+                if (cell_end <= ptr) {
+                    // tail of the last page of the large object
+                    ptr = next_page;
+                    continue;
+                }
+                f(cell);
+                ptr = cell_end;
+            }
+            visited_end = ptr;
+        });
     }
 private:
+    static inline void index(const byte* mem, size_t size, memory_descriptor descriptor)
+    {
+        if (heap_table.contains(mem)) {
+            heap_table.index(mem, size, descriptor);
+            heap_cards.cover(mem, size);
+        } else {
+            indexer.index(mem, size, descriptor);
+            if (descriptor.is_gc_heap_descriptor()) {
+                heap_overflow.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
     static index_tree indexer;
+    static page_table heap_table;
+    static mark_bitmap heap_marks;
+    static card_table heap_cards;
+    static std::atomic<bool> heap_overflow;
 };
 
 }}}
 
-#endif //ALLOCGC_MEMORY_INDEX_HPP
\ No newline at end of file
+#endif //ALLOCGC_MEMORY_INDEX_HPP
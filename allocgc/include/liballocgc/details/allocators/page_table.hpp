@@ -0,0 +1,95 @@
+#ifndef ALLOCGC_PAGE_TABLE_HPP
+#define ALLOCGC_PAGE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <atomic>
+
+#include <liballocgc/gc_common.hpp>
+#include <liballocgc/details/constants.hpp>
+#include <liballocgc/details/utils/utility.hpp>
+#include <liballocgc/details/allocators/memory_descriptor.hpp>
+
+namespace allocgc { namespace details { namespace allocators {
+
+/**
+ * Flat direct-mapped index of memory descriptors for a contiguous range of memory.
+ * Entry of a page is found by (ptr - base) >> PAGE_SIZE_LOG2, without any indirection.
+ *
+ * Table memory is reserved for the whole range but committed by the OS lazily,
+ * i.e. only the parts covering the used memory consume physical pages.
+ *
+ * Table memory is never released: like the range itself, it should outlive all static objects
+ * which can touch the heap during destruction.
+ */
+class page_table : private utils::noncopyable, private utils::nonmovable
+{
+    typedef std::atomic<memory_descriptor> entry_t;
+public:
+    constexpr page_table()
+        : m_base(0)
+        , m_size(0)
+        , m_table(nullptr)
+        , m_used_size(0)
+    {}
+
+    // can be called only once, before any memory of the range is indexed
+    void init(const byte* base, size_t size);
+
+    inline bool contains(const byte* mem) const
+    {
+        return reinterpret_cast<std::uintptr_t>(mem) - m_base < m_size;
+    }
+
+    void index(const byte* mem, size_t size, memory_descriptor descriptor)
+    {
+        assert(reinterpret_cast<std::uintptr_t>(mem) % PAGE_SIZE == 0);
+        assert(contains(mem) && contains(mem + size - 1));
+        size_t first = page_idx(mem);
+        size_t last  = page_idx(mem + size - 1);
+        for (size_t i = first; i <= last; ++i) {
+            assert(!m_table[i].load(std::memory_order_relaxed));
+            m_table[i].store(descriptor, std::memory_order_release);
+        }
+        size_t used_size = m_used_size.load(std::memory_order_relaxed);
+        while (used_size < last + 1 && !m_used_size.compare_exchange_weak(used_size, last + 1)) {}
+    }
+
+    void deindex(const byte* mem, size_t size)
+    {
+        assert(reinterpret_cast<std::uintptr_t>(mem) % PAGE_SIZE == 0);
+        assert(contains(mem) && contains(mem + size - 1));
+        size_t first = page_idx(mem);
+        size_t last  = page_idx(mem + size - 1);
+        for (size_t i = first; i <= last; ++i) {
+            m_table[i].store(nullptr, std::memory_order_release);
+        }
+    }
+
+    inline memory_descriptor get_descriptor(const byte* mem) const
+    {
+        assert(contains(mem));
+        return m_table[page_idx(mem)].load(std::memory_order_acquire);
+    }
+
+    // size of the table memory covering the used part of the range
+    size_t size() const
+    {
+        return m_used_size.load(std::memory_order_relaxed) * sizeof(entry_t);
+    }
+private:
+    inline size_t page_idx(const byte* mem) const
+    {
+        return (reinterpret_cast<std::uintptr_t>(mem) - m_base) >> PAGE_SIZE_LOG2;
+    }
+
+    std::uintptr_t      m_base;
+    size_t              m_size;
+    entry_t*            m_table;
+    std::atomic<size_t> m_used_size;
+};
+
+}}}
+
+#endif //ALLOCGC_PAGE_TABLE_HPP
@@ -33,16 +33,18 @@ public:
     redirection_allocator& operator=(const redirection_allocator&) = default;
     redirection_allocator& operator=(redirection_allocator&&) = default;
 
-    byte* allocate(size_t size)
+    template <typename... Args>
+    byte* allocate(size_t size, const Args&... args)
     {
         assert(m_alloc);
-        return m_alloc->allocate(size);
+        return m_alloc->allocate(size, args...);
     }
 
-    void deallocate(byte* ptr, size_t size)
+    template <typename... Args>
+    void deallocate(byte* ptr, size_t size, const Args&... args)
     {
         assert(m_alloc);
-        m_alloc->deallocate(ptr, size);
+        m_alloc->deallocate(ptr, size, args...);
     }
 
     memory_range_type memory_range()
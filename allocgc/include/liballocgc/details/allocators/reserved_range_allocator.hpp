@@ -0,0 +1,50 @@
+#ifndef ALLOCGC_RESERVED_RANGE_ALLOCATOR_HPP
+#define ALLOCGC_RESERVED_RANGE_ALLOCATOR_HPP
+
+#include <cstddef>
+
+#include <boost/range/iterator_range.hpp>
+
+#include <liballocgc/details/allocators/allocator_tag.hpp>
+#include <liballocgc/gc_common.hpp>
+
+namespace allocgc { namespace details { namespace allocators {
+
+/**
+ * Page allocator that carves memory out of a single range of virtual memory reserved at startup,
+ * so that all the gc heap lives in a known range and can be indexed by the flat page table.
+ * When the range is exhausted it falls back to mmap.
+ *
+ * Size of the range can be set by ALLOCGC_HEAP_RESERVE environment variable (in bytes),
+ * zero value disables the reservation.
+ */
+class reserved_range_allocator
+{
+public:
+    typedef byte* pointer_type;
+    typedef stateless_alloc_tag alloc_tag;
+    typedef boost::iterator_range<byte*> memory_range_type;
+
+    static const size_t DEFAULT_RESERVE_SIZE;
+
+    static byte* allocate(size_t size);
+    static void deallocate(byte* ptr, size_t size);
+
+    static bool contains(const byte* ptr);
+
+    static size_t shrink()
+    {
+        return 0;
+    }
+
+    static memory_range_type memory_range()
+    {
+        return memory_range_type(nullptr, nullptr);
+    }
+
+    static memory_range_type reserved_range();
+};
+
+}}}
+
+#endif //ALLOCGC_RESERVED_RANGE_ALLOCATOR_HPP
@@ -2,11 +2,15 @@
 #define ALLOCGC_INCREMENTAL_GC_HPP
 
 #include <mutex>
+#include <atomic>
 
 #include <liballocgc/details/collectors/gc_core.hpp>
 #include <liballocgc/details/collectors/packet_manager.hpp>
 #include <liballocgc/details/collectors/remset.hpp>
 #include <liballocgc/details/collectors/marker.hpp>
+#include <liballocgc/details/collectors/gc_pacer.hpp>
+#include <liballocgc/details/allocators/memory_index.hpp>
+#include <liballocgc/details/gc_unsafe_scope.hpp>
 #include <liballocgc/details/utils/utility.hpp>
 
 namespace allocgc { namespace details { namespace collectors {
@@ -21,18 +25,97 @@ public:
     void commit(const gc_alloc::response& rsp);
     void commit(const gc_alloc::response& rsp, const gc_type_meta* type_meta);
 
-    void  wbarrier(gc_handle& dst, const gc_handle& src);
+    /**
+     * The barrier runs in unsafe scope, so that no pause can come between the check of the marking flag,
+     * the store and its recording. Repeating the store made outside of the scope when the pauses have happened
+     * in between is not enough: the thread stopped by the pause which starts the marking could be stopped again
+     * by the final one before the repeat, and the pointer stored meanwhile could be already freed.
+     * Pending scope is inline, so while no marking is running the barrier is the store, the relaxed load of the flag
+     * and the update of the thread-local depth of the scope.
+     *
+     * During marking the card of the handle is dirtied in the same unsafe scope as the store,
+     * if the handle is in the reserved heap, and the dirty cards are scanned before the final pause and in it.
+     * Only stores into the other memory (stacks, static data, heap memory outside of the reserved range)
+     * put the pointer into the remset. Cards are not dirtied while no marking is running,
+     * since the pause which starts the marking clears them anyway.
+     */
+    void wbarrier(gc_handle& dst, const gc_handle& src)
+    {
+        gc_unsafe_scope unsafe_scope;
+        if (is_marking()) {
+            wbarrier_marking(dst, src);
+            return;
+        }
+        byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(src);
+        gc_handle_access::set<std::memory_order_release>(dst, ptr);
+    }
 
     gc_runstat gc_impl(const gc_options& options);
 
+    /**
+     * If there are no spare cores for the marker threads then marking is incremental:
+     * mutators do the slice of marking work proportional to the allocated memory on the allocation slow path,
+     * while the remset keeps the marking correct.
+     */
+    void mark_increment_impl(size_t alloc_size);
+
     gc_info info() const override;
+protected:
+    // is changed only in the pauses, so the value is stable in unsafe scope
+    bool is_marking() const
+    {
+        return m_marking.load(std::memory_order_relaxed);
+    }
+
+    // adds the pointer to the remset if its cell is not marked yet, should be called in unsafe scope during marking
+    void remember(byte* ptr);
+
+    /**
+     * Steps of the marking cycle which depend on the barrier.
+     *
+     * start_barrier is called in the pause which starts the marking, preclean_barrier is called concurrently
+     * with mutators before the final pause, and remark is called in the final pause and traces everything
+     * the barrier has recorded along with pins and uninitialized objects.
+     * gc_cms clears the cards at the start and rescans the dirty cards while precleaning and in remark.
+     */
+    virtual void start_barrier();
+    virtual void preclean_barrier();
+    virtual void remark(const threads::world_snapshot& snapshot);
 private:
+    // bytes to scan per allocated byte during incremental marking
+    static const size_t MARK_INCREMENT_RATIO = 2;
+
+    // size of the remset that is left for the final pause
+    static const size_t PRECLEAN_REMSET_SIZE = 1024;
+    // memory scanned by one round of precleaning
+    static const size_t PRECLEAN_BUDGET = 256 * 1024;
+    static const gc_clock::duration PRECLEAN_TIME_LIMIT;
+
+    // should be called in unsafe scope during marking
+    void wbarrier_marking(gc_handle& dst, const gc_handle& src);
+
+    // should be called in each pause after the phase has been changed
+    void update_marking_flag();
+
     gc_runstat start_marking_phase();
     gc_runstat sweep();
 
+    /**
+     * Drains the dirty cards (see preclean_barrier), the remset and the rest of marking work concurrently with mutators
+     * before the final pause, so that the pause handles only uninitialized objects, pins and a small residual remset.
+     */
+    void preclean();
+
+    // updates the start of the next marking phase and the number of marker threads
+    void pace();
+
     remset m_remset;
+    std::atomic<bool> m_marking;
     std::mutex m_mutex;
     gc_phase m_phase;
+    bool m_incremental;
+    gc_pacer m_pacer;
+    size_t m_marker_threads;
 };
 
 }}}
@@ -19,7 +19,7 @@ class gc_core : public gc_launcher, private utils::noncopyable, private utils::n
 {
 public:
     gc_core(remset* rset)
-        : m_marker(&m_packet_manager, rset)
+        : m_marker(&m_packet_manager, rset, [this] (const gc_cell_callback& cb) { m_heap.trace_live(cb); })
         , m_heap(this)
         , m_threads_available(std::thread::hardware_concurrency())
         , m_gc_cnt(0)
@@ -193,12 +193,26 @@ public:
         return stat;
     }
 
+    void mark_increment(size_t alloc_size) override
+    {
+        gc_safe_scope safe_scope;
+        // if the lock is taken then somebody else is collecting or marking already
+        std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            static_cast<Derived*>(this)->mark_increment_impl(alloc_size);
+        }
+    }
+
     gc_stat stats()
     {
         gc_stat stats = {
                 .gc_count   = m_gc_cnt,
                 .gc_time    = m_gc_time,
-                .gc_mem     = m_heap.stats()
+                .gc_mem     = m_heap.stats(),
+                .mark_mem   = m_marker.marked_mem(),
+                .mark_time  = m_marker.mark_time(),
+                .minor_pauses = m_minor_pauses,
+                .major_pauses = m_major_pauses
         };
         return stats;
     }
@@ -223,11 +237,21 @@ protected:
         return m_thread_manager.stop_the_world();
     }
 
+    // stacks of the threads and shards of the static roots are scanned in parallel
     void trace_roots(const threads::world_snapshot& snapshot)
     {
-        snapshot.trace_roots([this] (gc_handle* root) { root_trace_cb(root); });
-        logging::info() << "Trace static roots";
-        m_static_roots.trace([this] (gc_handle* root) { root_trace_cb(root); });
+        std::vector<marker::root_scanner> scanners;
+        snapshot.for_each_thread([&scanners] (const threads::gc_thread_descriptor* thread) {
+            scanners.emplace_back([thread] (const gc_trace_callback& cb) { thread->trace_roots(cb); });
+        });
+        size_t shards_cnt = m_static_roots.shards_count(m_threads_available);
+        for (size_t i = 0; i < shards_cnt; ++i) {
+            scanners.emplace_back([this, i, shards_cnt] (const gc_trace_callback& cb) {
+                m_static_roots.trace(cb, i, shards_cnt);
+            });
+        }
+        logging::info() << "Trace roots (" << scanners.size() << " partitions)";
+        m_marker.trace_roots(scanners, m_threads_available);
     }
 
     void trace_pins(const threads::world_snapshot& snapshot)
@@ -245,24 +269,89 @@ protected:
         m_marker.trace_remset();
     }
 
+    void trace_cards()
+    {
+        m_marker.trace_cards();
+    }
+
+    // traces the handles reported by the scanner as roots, e.g. the remembered slots of the old generation
+    void trace_slots(const marker::root_scanner& scanner)
+    {
+        m_marker.trace_roots({scanner}, 1);
+    }
+
+    // in the young-only mode the marker and the pin callbacks mark only the cells of the nursery
+    void set_young_only_marking(bool young_only)
+    {
+        m_marker.set_young_only(young_only);
+    }
+
     void start_concurrent_marking(size_t threads_available)
     {
         m_marker.concurrent_mark(threads_available);
     }
-    void start_marking()
+    void start_marking(size_t helper_threads = 0)
+    {
+        m_marker.mark(helper_threads);
+    }
+
+    // collectors which do not support incremental marking ignore the slices
+    void mark_increment_impl(size_t alloc_size)
+    {}
+
+    bool mark_slice(size_t budget)
+    {
+        return m_marker.mark_increment(budget);
+    }
+
+    const marker& get_marker() const
     {
-        m_marker.mark();
+        return m_marker;
+    }
+
+    gc_heap& get_heap()
+    {
+        return m_heap;
     }
 
     gc_collect_stat collect(const threads::world_snapshot& snapshot, size_t threads_available)
     {
+        // the world is stopped, so nobody walks through the memory index
+        allocators::memory_index::reclaim();
         return m_heap.collect(snapshot, threads_available, &m_static_roots);
     }
 
+    gc_collect_stat collect_nursery(const threads::world_snapshot& snapshot, size_t threads_available,
+                                    std::vector<gc_handle*>& young_slots)
+    {
+        allocators::memory_index::reclaim();
+        return m_heap.collect_nursery(snapshot, threads_available, &m_static_roots, young_slots);
+    }
+
+    gc_collect_stat collect_fresh(size_t threads_available)
+    {
+        allocators::memory_index::reclaim();
+        return m_heap.collect_fresh(threads_available);
+    }
+
     void shrink()
     {
         m_heap.shrink();
     }
+
+    // descriptor of the calling thread, null if the thread is not registered
+    static threads::gc_thread_descriptor* current_thread()
+    {
+        return this_thread;
+    }
+
+    // accounts the collection which has been performed bypassing gc(), e.g. by the thread on its own heap
+    void account_gc(const gc_options& options, const gc_runstat& stats)
+    {
+        gc_safe_scope safe_scope;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        after_gc(options, stats);
+    }
 private:
     void before_gc(const gc_options& options)
     {
@@ -291,28 +380,24 @@ private:
 
         ++m_gc_cnt;
         m_gc_time += runstats.pause;
+        if (runstats.gen == 0) {
+            m_minor_pauses.add(runstats.pause);
+        } else {
+            m_major_pauses.add(runstats.pause);
+        }
 
 //        std::cerr << "GC finish time: "
 //                  << std::chrono::duration_cast<std::chrono::milliseconds>(clock_t::now() - m_tm).count()
 //                  << std::endl;
     }
 
-    void root_trace_cb(gc_handle* root)
-    {
-        byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(*root);
-        if (ptr) {
-            gc_cell cell = allocators::memory_index::get_gc_cell(ptr);
-            cell.set_mark(true);
-            m_marker.add_root(cell);
-
-            logging::debug() << "root: " << (void*) root /* << "; point to: " << (void*) obj_start */;
-        }
-    }
-
     void pin_trace_cb(byte* ptr)
     {
         if (ptr) {
             gc_cell cell = allocators::memory_index::get_gc_cell(ptr);
+            if (!m_marker.is_traced(cell)) {
+                return;
+            }
             cell.set_mark(true);
             cell.set_pin(true);
             m_marker.add_root(cell);
@@ -325,8 +410,11 @@ private:
     {
         assert(obj_start && obj_size > 0);
         gc_cell cell = allocators::memory_index::get_gc_cell(obj_start);
-        cell.set_mark(true);
-        cell.set_pin(true);
+        // old object is not marked by the young-only marking, but its pointers to the nursery are still pinned
+        if (m_marker.is_traced(cell)) {
+            cell.set_mark(true);
+            cell.set_pin(true);
+        }
 
         logging::info() << "uninitialized object: " << (void*) obj_start /* << "; point to: " << (void*) obj_start */;
 
@@ -335,7 +423,7 @@ private:
         for (gc_handle* it = begin; it < end; ++it) {
             byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(*it);
             cell = allocators::memory_index::get_gc_cell(ptr);
-            if (!cell.get_mark() && cell.is_init()) {
+            if (m_marker.is_traced(cell) && !cell.get_mark() && cell.is_init()) {
                 cell.set_mark(true);
                 cell.set_pin(true);
                 m_marker.add_root(cell);
@@ -383,6 +471,8 @@ private:
     size_t m_threads_available;
     size_t m_gc_cnt;
     gc_clock::duration m_gc_time;
+    gc_pause_histogram m_minor_pauses;
+    gc_pause_histogram m_major_pauses;
     std::mutex m_mutex;
     clock_t::time_point m_tm;
 };
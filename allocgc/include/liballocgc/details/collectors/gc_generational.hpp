@@ -0,0 +1,110 @@
+#ifndef ALLOCGC_GC_GENERATIONAL_HPP
+#define ALLOCGC_GC_GENERATIONAL_HPP
+
+#include <vector>
+
+#include <liballocgc/details/collectors/gc_core.hpp>
+#include <liballocgc/details/collectors/remset.hpp>
+#include <liballocgc/details/allocators/memory_index.hpp>
+#include <liballocgc/details/gc_unsafe_scope.hpp>
+#include <liballocgc/details/utils/utility.hpp>
+
+namespace allocgc { namespace details { namespace collectors {
+
+/**
+ * Stop-the-world generational collector.
+ *
+ * Small objects are allocated in the nursery (young chunks of the thread pool allocators).
+ * Minor collection marks only the young cells reachable from the roots and from the remembered slots of the old generation,
+ * then evacuates them into the old allocators of the same size class. Pinned survivors stay in the nursery.
+ * Major collection marks and sweeps the whole heap in place, as gc_serial does.
+ *
+ * Old-to-young pointers are tracked by the write barrier: stores into the reserved heap dirty the cards,
+ * and the minor collection scans the old cells lying on the dirty cards.
+ *
+ * In the sticky mark bits mode objects are never moved. Small objects are allocated in the old allocators,
+ * and the nursery is only the allocation budget between the collections. Mark bits are not reset after the collection,
+ * thus the young cells are the unmarked ones. Minor collection marks the cells reachable from the roots
+ * and from the remembered slots (the marked cells are not traced again) and sweeps only the chunks
+ * allocated from since the last collection, its survivors become old just by keeping their marks.
+ */
+class gc_generational : public gc_core<gc_generational>, private utils::noncopyable, private utils::nonmovable
+{
+public:
+    gc_generational();
+
+    /**
+     * As in gc_cms, the load, the store and the dirtying of the card are done in one unsafe scope,
+     * so no pause (which could move the objects or scan the cards) can come in between.
+     *
+     * Slots of the heap memory outside of the reserved range are not covered by the cards,
+     * stores into them are remembered out of line.
+     */
+    void wbarrier(gc_handle& dst, const gc_handle& src)
+    {
+        gc_unsafe_scope unsafe_scope;
+        byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(src);
+        gc_handle_access::set<std::memory_order_release>(dst, ptr);
+        bool carded = allocators::memory_index::heap_card_table().dirty(reinterpret_cast<const byte*>(&dst));
+        if (!carded && allocators::memory_index::heap_overflowed()) {
+            remember_slot(reinterpret_cast<byte*>(&dst));
+        }
+    }
+
+    /**
+     * Pointers stored into the objects under construction bypass wbarrier (see gc_untyped_ptr),
+     * so the slot is carded here. Racing pause is harmless, since the uninitialized object is scanned conservatively.
+     */
+    void register_handle(gc_handle& handle, byte* ptr)
+    {
+        gc_core::register_handle(handle, ptr);
+        if (ptr && !allocators::memory_index::heap_card_table().dirty(reinterpret_cast<const byte*>(&handle))
+            && allocators::memory_index::heap_overflowed()) {
+            register_handle_slow(handle);
+        }
+    }
+
+    // minor collection is requested with gen == 0, any other request collects the whole heap
+    gc_runstat gc_impl(const gc_options& options);
+
+    void set_nursery_size(size_t size);
+
+    // should be called before the first thread is registered
+    void set_sticky_marks(bool sticky);
+
+    gc_info info() const override;
+private:
+    // major collection is scheduled when the heap is filled above this part of its limit after the minor one
+    static const double MAJOR_THRESHOLD;
+
+    void register_handle_slow(gc_handle& handle);
+
+    // remembers the heap slot in the remset if it is not covered by the cards, should be called in unsafe scope
+    void remember_slot(byte* slot);
+
+    gc_runstat minor_collect();
+    gc_runstat sticky_minor_collect();
+    gc_runstat major_collect();
+
+    bool is_young(const gc_cell& cell) const;
+    bool points_to_young(const gc_handle* slot) const;
+
+    /**
+     * Gathers the slots of the old generation which point to the nursery:
+     * slots left by the previous collections, slots of the remset and the slots of the old cells on the dirty cards.
+     */
+    void scan_young_slots();
+
+    // slots which still point to the nursery after the collection are kept dirty in the card table if possible
+    void remember_young_slots();
+
+    // slots which are not covered by the cards
+    remset m_slots;
+    std::vector<gc_handle*> m_young_slots;
+    bool m_major_requested;
+    bool m_sticky_marks;
+};
+
+}}}
+
+#endif //ALLOCGC_GC_GENERATIONAL_HPP
@@ -6,6 +6,7 @@
 #include <cstddef>
 #include <mutex>
 #include <memory>
+#include <vector>
 #include <unordered_map>
 
 #include <liballocgc/gc_alloc.hpp>
@@ -15,6 +16,7 @@
 #include <liballocgc/details/allocators/gc_core_allocator.hpp>
 #include <liballocgc/details/allocators/gc_lo_allocator.hpp>
 #include <liballocgc/details/allocators/gc_so_allocator.hpp>
+#include <liballocgc/details/allocators/gc_nursery.hpp>
 
 #include <liballocgc/details/collectors/static_root_set.hpp>
 
@@ -52,17 +54,90 @@ public:
             collectors::static_root_set* static_roots
     );
 
+    /**
+     * Minor collection: evacuates the marked cells of the nursery into the old generation.
+     *
+     * Remembered slots of the old generation (young_slots) are forwarded along with the roots,
+     * on return young_slots holds all the slots of the old generation which still point to the nursery
+     * (i.e. to the pinned survivors).
+     */
+    gc_collect_stat collect_nursery(
+            const threads::world_snapshot& snapshot,
+            size_t threads_available,
+            collectors::static_root_set* static_roots,
+            std::vector<gc_handle*>& young_slots
+    );
+
+    /**
+     * Minor collection of the sticky mark bits mode: sweeps the unmarked cells allocated since the last collection.
+     *
+     * In this mode mark bits are kept after the collections, so the old cells are the marked ones,
+     * and the major collection should reset the marks before the marking.
+     */
+    gc_collect_stat collect_fresh(size_t threads_available);
+
+    /**
+     * Local collection of the thread-local heaps mode: sweeps the unmarked local cells of the fresh chunks
+     * of the single tlab and unmarks the local survivors.
+     *
+     * It is called by the owner of the tlab without stopping the world, so it touches neither other tlabs
+     * nor the memory index. Marks and shared bits of the tlab cells are changed only by their owner
+     * while the world is running, since the local cells are reachable only from the owner.
+     */
+    gc_collect_stat collect_local(tlab* local_heap);
+
+    // resets mark and pin bits of the whole heap
+    void reset_marks();
+
+    // calls the callback for each live cell of the heap; the world should be stopped
+    void trace_live(const gc_cell_callback& cb);
+
     gc_memstat stats();
 
     void shrink();
 
+    size_t size() const;
+    size_t limit() const;
+
     void set_limit(size_t limit);
+    void set_mark_trigger(double trigger);
+
+    // threads registered after the first call allocate in the nursery
+    void set_nursery_size(size_t size);
+
+    // nursery is used only as the allocation budget between the collections, cells are never moved
+    void set_sticky_marks(bool sticky);
+
+    // each thread has its own allocation budget (of the nursery size), mark bits are reset by the global collections
+
+    void set_thread_local_heaps(bool thread_local_heaps);
 private:
     typedef std::unordered_map<std::thread::id, so_alloc_t> tlab_map_t;
+    typedef std::unordered_map<std::thread::id, allocators::gc_nursery> budget_map_t;
+
+    // visits the small objects allocators of both generations
+    template <typename Functor>
+    void for_each_tlab(Functor&& f)
+    {
+        for (auto& kv: m_tlab_map) {
+            f(kv.second);
+        }
+        for (auto& kv: m_nursery_map) {
+            f(kv.second);
+        }
+    }
 
     core_alloc_t    m_core_alloc;
     lo_alloc_t      m_loa;
     tlab_map_t      m_tlab_map;
+    // young allocators of the threads, their cells are promoted to the allocators of m_tlab_map
+    tlab_map_t      m_nursery_map;
+    allocators::gc_nursery m_nursery;
+    // budgets of the thread-local heaps
+    budget_map_t    m_local_budgets;
+    bool            m_nursery_enabled;
+    bool            m_sticky_marks;
+    bool            m_thread_local_heaps;
     std::mutex      m_mutex;
 };
 
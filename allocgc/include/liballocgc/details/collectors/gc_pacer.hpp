@@ -0,0 +1,62 @@
+#ifndef ALLOCGC_GC_PACER_HPP
+#define ALLOCGC_GC_PACER_HPP
+
+#include <cstddef>
+
+namespace allocgc { namespace details { namespace collectors {
+
+/**
+ * Pacer schedules the start of concurrent marking (in the spirit of the Go GC pacer).
+ *
+ * For each cycle it measures how much the heap has grown while the marking was in progress,
+ * i.e. the product of the allocation rate and the marking time, relative to the heap limit.
+ * If the marking has not been finished before the final pause, the growth is extrapolated
+ * by the part of live memory marked concurrently.
+ * The next marking starts early enough for this growth to fit below the heap limit,
+ * and the number of marker threads is chosen so that it fits into the default headroom.
+ */
+class gc_pacer
+{
+public:
+    gc_pacer();
+
+    // called when concurrent marking starts, marker_threads is 0 for incremental marking
+    void start_cycle(size_t heap_size, size_t marked_mem, size_t marker_threads);
+
+    // called when concurrent marking has run out of work
+    void concurrent_done(size_t heap_size);
+
+    // called in the final pause before (concurrent_marked_mem) and after (marked_mem) the remaining marking
+    void finish_cycle(size_t heap_size, size_t heap_limit, size_t concurrent_marked_mem, size_t marked_mem);
+
+    // part of the heap limit at which the next concurrent marking should start
+    double mark_trigger(size_t marker_threads) const;
+
+    // number of marker threads (not more than threads_max), which is enough to finish marking in the default headroom
+    size_t marker_threads(size_t threads_max) const;
+
+    static const double DEFAULT_TRIGGER;
+    static const double MIN_TRIGGER;
+    static const double MAX_TRIGGER;
+private:
+    // estimates are increased by this factor, since the next cycle can be heavier than the previous one
+    static const double SAFETY_FACTOR;
+    // weight of the last cycle in the estimate
+    static const double SMOOTHING_FACTOR;
+
+    // heap growth during marking relative to the heap limit
+    double marking_growth(size_t marker_threads) const;
+
+    // growth of the heap during marking by one thread (or by incremental marking) relative to the heap limit
+    double m_growth;
+    bool   m_calibrated;
+    bool   m_incremental;
+    size_t m_cycle_threads;
+    size_t m_cycle_heap_size;
+    size_t m_cycle_marked_mem;
+    size_t m_done_heap_size;
+};
+
+}}}
+
+#endif //ALLOCGC_GC_PACER_HPP
@@ -0,0 +1,40 @@
+#ifndef ALLOCGC_GC_SATB_HPP
+#define ALLOCGC_GC_SATB_HPP
+
+#include <liballocgc/details/collectors/gc_cms.hpp>
+#include <liballocgc/details/gc_unsafe_scope.hpp>
+
+namespace allocgc { namespace details { namespace collectors {
+
+/**
+ * Concurrent mark & sweep collector with the snapshot-at-the-beginning (Yuasa) barrier.
+ *
+ * During marking the barrier logs the overwritten value instead of the stored one,
+ * so the marking traces the heap as it was at the start of the cycle (plus allocated objects, which are black),
+ * and the final pause only drains the buffers of the barrier.
+ * The cycle itself is the same as in gc_cms, but the cards are neither dirtied nor scanned.
+ */
+class gc_satb : public gc_cms
+{
+public:
+    gc_satb() = default;
+
+    // as in gc_cms, the barrier runs in unsafe scope, so the overwritten value can not be lost to the pauses
+    void wbarrier(gc_handle& dst, const gc_handle& src)
+    {
+        gc_unsafe_scope unsafe_scope;
+        if (is_marking()) {
+            remember(gc_handle_access::get<std::memory_order_relaxed>(dst));
+        }
+        byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(src);
+        gc_handle_access::set<std::memory_order_release>(dst, ptr);
+    }
+protected:
+    void start_barrier() override;
+    void preclean_barrier() override;
+    void remark(const threads::world_snapshot& snapshot) override;
+};
+
+}}}
+
+#endif //ALLOCGC_GC_SATB_HPP
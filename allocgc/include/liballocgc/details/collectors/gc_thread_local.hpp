@@ -0,0 +1,105 @@
+#ifndef ALLOCGC_GC_THREAD_LOCAL_HPP
+#define ALLOCGC_GC_THREAD_LOCAL_HPP
+
+#include <atomic>
+
+#include <liballocgc/details/collectors/gc_core.hpp>
+#include <liballocgc/details/allocators/memory_index.hpp>
+#include <liballocgc/details/allocators/gc_pool_descriptor.hpp>
+#include <liballocgc/details/gc_unsafe_scope.hpp>
+#include <liballocgc/details/utils/utility.hpp>
+
+namespace allocgc { namespace details { namespace collectors {
+
+/**
+ * Collector with the thread-local heaps.
+ *
+ * Each thread allocates small objects in its own tlab, and the objects are local to the thread until they escape,
+ * i.e. until the pointer to them is stored into a slot reachable by other threads: into the static root
+ * (which also covers the non-gc heap memory), into the stack of another thread or into the shared object.
+ *
+ * Shared cells are tracked by the shared bits of the chunks, which are kept between the collections
+ * (see gc_pool_descriptor::is_shared_cell). Escaping object is shared along with all the local objects reachable
+ * from it before the store, thus the shared cells never point to the local ones. Large objects are shared at birth.
+ *
+ * Local collection is performed by the thread on its own tlab without stopping the world and without the gc lock:
+ * it marks the local cells reachable from the roots, pins and objects under construction of the thread,
+ * then sweeps the unmarked local cells of the tlab and unmarks the survivors, so they stay local.
+ * Global collection marks and sweeps the whole heap in place, as gc_serial does, and keeps the shared bits.
+ *
+ * Stores made through raw pointers are not seen by the barriers, so threads should neither access
+ * gc_ptr's lying on the stacks of other threads nor pass pinned pointers to each other.
+ */
+class gc_thread_local : public gc_core<gc_thread_local>, private utils::noncopyable, private utils::nonmovable
+{
+public:
+    gc_thread_local();
+
+    void wbarrier(gc_handle& dst, const gc_handle& src)
+    {
+        gc_unsafe_scope unsafe_scope;
+        byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(src);
+        if (ptr && is_local(ptr)) {
+            escape(reinterpret_cast<byte*>(&dst), ptr);
+        }
+        gc_handle_access::set<std::memory_order_release>(dst, ptr);
+    }
+
+    /**
+     * Pointers stored into the objects under construction bypass wbarrier (see gc_untyped_ptr).
+     * Racing global collection is harmless, since it does not change the shared bits.
+     */
+    void register_handle(gc_handle& handle, byte* ptr)
+    {
+        if (ptr && is_local(ptr)) {
+            escape(reinterpret_cast<byte*>(&handle), ptr);
+        }
+        gc_core::register_handle(handle, ptr);
+    }
+
+    // collection of gen == 0 requested by the registered thread is the local collection of its tlab
+    gc_runstat gc(const gc_options& options) override;
+
+    gc_runstat gc_impl(const gc_options& options);
+
+    // allocation budget of the thread-local heap between its collections, applies to the threads registered after the call
+    void set_local_heap_size(size_t size);
+
+    gc_info info() const override;
+private:
+    // global collection is scheduled when the heap is filled above this part of its limit after the local one
+    static const double GLOBAL_THRESHOLD;
+
+    static bool is_local(byte* ptr)
+    {
+        return !allocators::gc_pool_descriptor::is_shared_cell(allocators::memory_index::get_gc_cell(ptr));
+    }
+
+    // slot is local if it lies on the stack of the calling thread or in the local cell
+    static bool is_local_slot(byte* slot);
+
+    // makes the local object shared unless it is stored into the local slot
+    static void escape(byte* slot, byte* ptr);
+
+    // shares the cell and all the local cells reachable from it
+    static void share_local(const gc_cell& cell);
+
+    // marks the cell and all the unmarked local cells reachable from it
+    static void mark_local(const gc_cell& cell);
+
+    /**
+     * Visits the local cells reachable from the cell, which are taken by the functor, i.e. for which it returns true.
+     * Objects under construction are scanned conservatively.
+     */
+    template <typename Functor>
+    static void trace_local(const gc_cell& cell, Functor&& take);
+
+    gc_runstat local_collect();
+    gc_runstat global_collect();
+
+    std::atomic<bool> m_global_requested;
+};
+
+}}}
+
+#endif //ALLOCGC_GC_THREAD_LOCAL_HPP
@@ -2,6 +2,7 @@
 #define ALLOCGC_MARKER_HPP
 
 #include <vector>
+#include <functional>
 #include <mutex>
 #include <memory>
 #include <atomic>
@@ -11,51 +12,178 @@
 #include <liballocgc/details/collectors/remset.hpp>
 #include <liballocgc/details/collectors/packet_manager.hpp>
 #include <liballocgc/details/allocators/memory_index.hpp>
+#include <liballocgc/details/allocators/gc_pool_descriptor.hpp>
 #include <liballocgc/details/threads/world_snapshot.hpp>
 #include <liballocgc/details/utils/scoped_thread.hpp>
+#include <liballocgc/details/utils/dynarray.hpp>
 #include <liballocgc/details/utils/utility.hpp>
 
 namespace allocgc { namespace details { namespace collectors {
 
-class marking_overflow_exception : public gc_exception
-{
-public:
-    marking_overflow_exception()
-        : gc_exception("Mark stack overflow")
-    {}
-};
-
 class marker
 {
 public:
-    marker(packet_manager* manager, remset* rset);
+    // calls the callback for each marked initialized cell of the heap
+    typedef std::function<void(const gc_cell_callback&)> heap_walker;
+
+    // calls the callback for each root of some partition of the root set (e.g. the stack of one thread)
+    typedef std::function<void(const gc_trace_callback&)> root_scanner;
+
+    /**
+     * If all the packets of the manager are in use then the cell is left marked but untraced
+     * and the marker falls back to the rescan of the marked cells of the heap (see heap_walker).
+     */
+    marker(packet_manager* manager, remset* rset, const heap_walker& walker = heap_walker());
 
     ~marker();
 
     void add_root(const gc_cell& cell);
 
+    /**
+     * Marks the roots reported by the scanners and pushes them to the mark packets.
+     * Scanners are distributed among threads_num threads, each of them fills its own output packets.
+     */
+    void trace_roots(const std::vector<root_scanner>& scanners, size_t threads_num);
+
     void trace_remset();
 
-    void mark();
+    /**
+     * Cleans the dirty cards of the heap card table and traces the marked initialized cells lying on them.
+     * It can be called concurrently with mutators, stores made after the card has been cleaned dirty it again.
+     */
+    void trace_cards();
+
+    /**
+     * Finishes the marking on the calling thread. Workers of the concurrent marking which are still running
+     * help it, if all of them have already finished then threads_num new helpers are launched.
+     */
+    void mark(size_t threads_num = 0);
     void concurrent_mark(size_t threads_num);
+
+    /**
+     * In the young-only mode cells of the old generation are neither marked nor traced, they are considered live.
+     * Pointers from the old generation to the nursery should be passed as roots then.
+     * Mode can be changed only when the marking is not in progress.
+     */
+    void set_young_only(bool young_only);
+
+    inline bool is_traced(const gc_cell& cell) const
+    {
+        return !m_young_only || allocators::gc_pool_descriptor::is_young_cell(cell);
+    }
+
+    /**
+     * Performs a slice of marking on the calling thread, until about budget bytes are scanned.
+     * It is used for incremental marking, i.e. when marking is started by concurrent_mark(0)
+     * and mutators do the marking work themselves; slices should not run concurrently with mark().
+     *
+     * Returns false if there was no more work.
+     */
+    bool mark_increment(size_t budget);
+
+    size_t marked_mem() const;
+    gc_clock::duration mark_time() const;
+
+    // returns true if all the threads launched by concurrent_mark have run out of work
+    bool concurrent_done() const;
 private:
-    static const size_t POP_REMSET_COUNT = 16;
-    static const size_t POP_OUTPUT_ATTEMPTS = 2;
+    static const size_t PREFETCH_DEPTH = 8;
+
+    /**
+     * Arrays bigger than ARRAY_CHUNK_SIZE bytes are not scanned at once, instead they are split into chunks
+     * of ARRAY_CHUNK_SIZE bytes, which are pushed to the mark packets and can be scanned by different workers.
+     * Chunk is stored in the packet as a cell pointing to the first object of the chunk.
+     */
+    static const size_t ARRAY_CHUNK_SIZE = 16 * 1024;
+
+    /**
+     * Cells popped from the mark packet are prefetched and traced only after PREFETCH_DEPTH more cells are popped,
+     * so that loads of their headers overlap with tracing of other cells.
+     */
+    class prefetch_ring
+    {
+    public:
+        prefetch_ring()
+            : m_head(0)
+            , m_size(0)
+        {}
+
+        // returns false if the ring is not full yet, otherwise evicts the oldest cell
+        bool push(const gc_cell& cell, gc_cell& evicted)
+        {
+            byte* ptr = cell.get();
+            __builtin_prefetch(ptr);
+            __builtin_prefetch(ptr + CACHE_LINE_SIZE);
+
+            size_t tail = (m_head + m_size) % PREFETCH_DEPTH;
+            if (m_size < PREFETCH_DEPTH) {
+                m_cells[tail] = cell;
+                ++m_size;
+                return false;
+            }
+            evicted = m_cells[m_head];
+            m_cells[m_head] = cell;
+            m_head = (m_head + 1) % PREFETCH_DEPTH;
+            return true;
+        }
+
+        bool pop(gc_cell& cell)
+        {
+            if (m_size == 0) {
+                return false;
+            }
+            cell = m_cells[m_head];
+            m_head = (m_head + 1) % PREFETCH_DEPTH;
+            --m_size;
+            return true;
+        }
+    private:
+        static const size_t CACHE_LINE_SIZE = 64;
+
+        gc_cell m_cells[PREFETCH_DEPTH];
+        size_t  m_head;
+        size_t  m_size;
+    };
+
+    // output packets, one per NUMA node, so that cells of different nodes are not mixed up in one packet
+    typedef utils::dynarray<packet_manager::mark_packet_handle> output_packets_t;
 
     void worker_routine();
 
-    void push_root_to_packet(const gc_cell& cell, packet_manager::mark_packet_handle& output_packet);
-    void push_to_packet(const gc_cell& cell, packet_manager::mark_packet_handle& output_packet);
+    // pops one chunk of the remset and returns the number of popped pointers
+    size_t pop_remset(output_packets_t& output_packets, size_t worker_id);
+
+    // marks the cell that does not fit into the mark packets, it will be traced during heap rescan
+    void overflow(const gc_cell& cell);
+
+    // traces all the marked cells of the heap, so that overflowed cells are traced as well
+    void rescan_heap();
+
+    size_t cell_numa_node(const gc_cell& cell) const;
+
+    void push_root_to_packet(const gc_cell& cell, output_packets_t& output_packets);
+    void push_root_to_packet(gc_handle* root, output_packets_t& output_packets);
+    void push_to_packet(const gc_cell& cell, output_packets_t& output_packets, size_t worker_id);
+    void push_output_packets(output_packets_t& output_packets, size_t worker_id = packet_manager::NO_WORKER);
+
+    // traces the cell or the chunk of the array, returns the size of the scanned memory
+    size_t scan(const gc_cell& item, output_packets_t& output_packets, size_t worker_id);
 
-    void trace(gc_handle* handle, packet_manager::mark_packet_handle& output_packet);
+    void trace(gc_handle* handle, output_packets_t& output_packets, size_t worker_id);
 
     packet_manager* m_packet_manager;
     remset* m_remset;
-    packet_manager::mark_packet_handle m_roots_packet;
+    heap_walker m_heap_walker;
+    output_packets_t m_roots_packets;
     std::vector<utils::scoped_thread> m_workers;
     std::atomic<size_t> m_running_threads_cnt;
     std::atomic<bool> m_concurrent_flag;
     std::atomic<bool> m_done;
+    std::atomic<bool> m_overflow;
+    bool m_young_only;
+    std::atomic<size_t> m_marked_mem;
+    gc_clock::time_point m_mark_start;
+    gc_clock::duration m_mark_time;
 };
 
 }}}
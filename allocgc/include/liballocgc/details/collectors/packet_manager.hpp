@@ -3,10 +3,13 @@
 
 #include <atomic>
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 
 #include <liballocgc/details/gc_cell.hpp>
+#include <liballocgc/details/utils/chase_lev_deque.hpp>
+#include <liballocgc/details/utils/dynarray.hpp>
 #include <liballocgc/details/utils/utility.hpp>
 #include <liballocgc/gc_common.hpp>
 
@@ -27,13 +30,17 @@ public:
     bool is_partial_full() const;
     bool is_empty() const;
 
+    // NUMA node of the cells in the packet
+    size_t numa_node() const;
+
     friend class packet_manager;
 private:
     static const size_t SIZE = 512;
 
     gc_cell      m_data[SIZE];
     size_t       m_size;
-    mark_packet* m_next;
+    size_t       m_numa_node;
+    std::atomic<mark_packet*> m_next;
 };
 
 class packet_manager : private utils::noncopyable, private utils::nonmovable
@@ -46,34 +53,112 @@ public:
 
     typedef std::unique_ptr<mark_packet, mark_packet_deleter> mark_packet_handle;
 
+    // id of the thread that is not a marking worker (its packets are always shared via global pools)
+    static const size_t NO_WORKER;
+
+    // upper bound on the number of packets, so that marking of very large graphs still takes bounded memory
+    static const size_t DEFAULT_MAX_PACKETS_COUNT = 8192;
+
     packet_manager();
+    explicit packet_manager(size_t numa_nodes_count, size_t max_packets_count = DEFAULT_MAX_PACKETS_COUNT);
+    ~packet_manager();
+
+    /**
+     * Each marking worker owns a work-stealing deque of full packets.
+     * Workers push their full packets to the own deque and pop them back in LIFO order,
+     * idle workers steal from the other deques.
+     *
+     * Returns id of the worker, or NO_WORKER if all deques are taken.
+     */
+    size_t attach_worker(size_t numa_node = 0);
+
+    // should be called when all the workers of the marking cycle have finished
+    void detach_workers();
+
+    // packets of the worker's deque and of the given node are preferred,
+    // packets of other nodes and workers are stolen only if there are no local ones
+    mark_packet_handle pop_input_packet(size_t numa_node = 0, size_t worker_id = NO_WORKER);
+
+    /**
+     * Packets are allocated from the side arena on demand (by PACKETS_COUNT at a time).
+     * Returns nullptr only if all max_packets_count packets are in use,
+     * in that case the caller should handle the mark stack overflow.
+     */
+    mark_packet_handle pop_output_packet(size_t numa_node = 0);
+    void push_packet(mark_packet_handle packet, size_t worker_id = NO_WORKER);
+
+    /**
+     * Termination protocol: the worker which has no input packets announces itself idle and
+     * waits until either some work appears (then it returns false and should try to pop input again)
+     * or all attached workers become idle (then it returns true and marking is finished).
+     *
+     * Idle worker should not hold any non-empty packet.
+     */
+    bool try_terminate();
 
-    mark_packet_handle pop_input_packet();
-    mark_packet_handle pop_output_packet();
-    void push_packet(mark_packet_handle packet);
     bool is_no_input() const;
+
+    size_t numa_nodes_count() const;
+
+    // number of packets allocated so far
+    size_t packets_count() const;
 private:
     static const size_t PACKETS_COUNT = 256;
+    static const size_t MAX_WORKERS_COUNT = 64;
+    static const size_t SPIN_COUNT = 64;
 
+    // lock-free stack of packets; packets are never freed, and the head keeps ABA counter along with the packet index
     class packet_pool : private utils::noncopyable, private utils::nonmovable
     {
     public:
-        packet_pool();
+        explicit packet_pool(mark_packet* storage = nullptr);
+
+        void set_storage(mark_packet* storage);
 
         void push(mark_packet_handle packet);
         mark_packet_handle pop();
 
         size_t size() const;
     private:
-        mark_packet* m_head;
-        size_t m_size;
-        mutable std::mutex m_mutex;
+        static const std::uint64_t NULL_IDX = 0;
+        static const size_t TAG_SHIFT = 32;
+        static const std::uint64_t IDX_MASK = ((std::uint64_t) 1 << TAG_SHIFT) - 1;
+
+        static std::uint64_t make_head(std::uint64_t idx, std::uint64_t prev_head);
+
+        mark_packet* m_storage;
+        std::atomic<std::uint64_t> m_head;
+        std::atomic<size_t> m_size;
     };
 
-    std::array<mark_packet, PACKETS_COUNT> m_packets_storage;
-    packet_pool m_full_packets;
-    packet_pool m_partial_packets;
+    typedef utils::chase_lev_deque<mark_packet, PACKETS_COUNT> deque_t;
+
+    struct worker_queue
+    {
+        deque_t m_deque;
+        size_t  m_numa_node;
+    };
+
+    bool grow();
+
+    mark_packet_handle pop_node_input_packet(size_t numa_node);
+    mark_packet_handle steal_packet(size_t worker_id);
+
+    bool has_visible_work() const;
+    size_t attached_workers_count() const;
+
+    // packets arena is reserved at once for max_packets_count packets, thus packets never move
+    mark_packet* m_packets_storage;
+    std::atomic<size_t> m_packets_count;
+    size_t m_max_packets_count;
+    size_t m_storage_size;
+    std::mutex m_grow_mutex;
+    utils::dynarray<packet_pool> m_full_packets;
+    utils::dynarray<packet_pool> m_partial_packets;
     packet_pool m_empty_packets;
+    std::array<worker_queue, MAX_WORKERS_COUNT> m_worker_queues;
+    std::atomic<size_t> m_attached_cnt;
+    std::atomic<size_t> m_idle_cnt;
 };
 
 }}}
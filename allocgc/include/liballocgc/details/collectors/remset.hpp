@@ -2,73 +2,142 @@
 #define ALLOCGC_REMSET_HPP
 
 #include <unordered_map>
-#include <unordered_set>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdint>
 
 #include <liballocgc/details/utils/utility.hpp>
 #include <liballocgc/gc_common.hpp>
 
 namespace allocgc { namespace details { namespace collectors {
 
+/**
+ * Remembered set of pointers stored by mutators during concurrent marking.
+ *
+ * Each mutator fills its own sequential store buffer (SSB), full buffers are pushed
+ * to the lock-free stack and consumed by markers chunk by chunk.
+ * Remset does not deduplicate pointers, markers skip cells that are already marked.
+ */
 class remset : private utils::noncopyable, private utils::nonmovable
 {
-    typedef std::unordered_set<byte*> hashtable_t;
 public:
-    typedef hashtable_t::const_iterator const_iterator;
-
-    remset() = default;
-
-    void  add(byte* ptr);
-    byte* get();
-
-    void clear();
+    remset(size_t max_chunks_count = MAX_CHUNKS_COUNT);
+    ~remset();
+
+    void add(byte* ptr);
+
+    /**
+     * Pops one chunk of pointers and applies functor to each of them.
+     *
+     * Returns the number of consumed pointers, zero means that the remset is empty.
+     */
+    template <typename Functor>
+    size_t consume(Functor&& f)
+    {
+        ssb_chunk* chunk = m_full_chunks.pop();
+        if (!chunk) {
+            return consume_overflow(std::forward<Functor>(f));
+        }
+        size_t size = chunk->m_size;
+        m_size.fetch_sub(size, std::memory_order_relaxed);
+        for (size_t i = 0; i < size; ++i) {
+            f(chunk->m_data[i]);
+        }
+        chunk->m_size = 0;
+        m_empty_chunks.push(chunk);
+        return size;
+    }
+
+    // moves buffers of all threads to the remset, should be called only during stop-the-world
     void flush_buffers();
 
+    // number of pointers in full chunks
     size_t size() const;
     bool empty() const;
-
-    // we use iterators here but it isn't best option,
-    // because we don't hold lock on hash table while we are tracing data through these iterators;
-    // however, because we do tracing only during stop-the-world it's ok;
-    // but we still need more consistent lock strategy
-    const_iterator begin() const;
-    const_iterator end() const;
 private:
-    class sequential_store_buffer : private utils::noncopyable, private utils::nonmovable
+    static const size_t MAX_CHUNKS_COUNT = 64 * 1024;
+
+    class ssb_chunk : private utils::noncopyable, private utils::nonmovable
     {
     public:
-        typedef byte* const* const_iterator;
+        static const size_t SSB_SIZE = 64;
 
-        sequential_store_buffer();
+        ssb_chunk();
 
         void push(byte* ptr);
-        void clear();
-
         bool is_full() const;
-
-        const_iterator begin() const;
-        const_iterator end() const;
     private:
         friend class remset;
 
-        static const size_t SSB_SIZE = 64;
-
         byte* m_data[SSB_SIZE];
         size_t m_size;
+        std::atomic<ssb_chunk*> m_next;
     };
 
-    typedef sequential_store_buffer ssb_t;
-    typedef std::unordered_map<std::thread::id, ssb_t> ssb_map_t;
+    // lock-free stack of chunks; chunks are never freed, and the head keeps ABA counter along with the chunk index
+    class chunk_pool : private utils::noncopyable, private utils::nonmovable
+    {
+    public:
+        explicit chunk_pool(ssb_chunk* storage);
+
+        void push(ssb_chunk* chunk);
+        ssb_chunk* pop();
+    private:
+        static const std::uint64_t NULL_IDX = 0;
+        static const size_t TAG_SHIFT = 32;
+        static const std::uint64_t IDX_MASK = ((std::uint64_t) 1 << TAG_SHIFT) - 1;
+
+        static std::uint64_t make_head(std::uint64_t idx, std::uint64_t prev_head);
+
+        ssb_chunk* m_storage;
+        std::atomic<std::uint64_t> m_head;
+    };
+
+    typedef std::unordered_map<std::thread::id, ssb_chunk*> ssb_map_t;
     typedef std::mutex mutex_t;
 
-    ssb_t& get_ssb();
-    void flush_ssb(ssb_t& ssb);
+    ssb_chunk*& get_ssb();
+    ssb_chunk* create_chunk();
 
-    hashtable_t m_hashtable;
+    // pushes the full buffer of the thread (if any) and returns an empty one, or null if the arena is exhausted
+    ssb_chunk* flush_ssb(ssb_chunk* ssb);
+
+    template <typename Functor>
+    size_t consume_overflow(Functor&& f)
+    {
+        if (m_overflow_size.load(std::memory_order_relaxed) == 0) {
+            return 0;
+        }
+        std::vector<byte*> overflow;
+        {
+            std::lock_guard<mutex_t> lock(m_overflow_mutex);
+            overflow.swap(m_overflow);
+            m_overflow_size.store(0, std::memory_order_relaxed);
+        }
+        for (byte* ptr: overflow) {
+            f(ptr);
+        }
+        return overflow.size();
+    }
+
+    // unique id of the remset, zero is never used
+    std::uint64_t m_id;
+    // chunks arena is reserved at once for max_chunks_count chunks, thus chunks never move
+    size_t m_storage_size;
+    ssb_chunk* m_chunks_storage;
+    size_t m_max_chunks_count;
+    std::atomic<size_t> m_chunks_count;
+    chunk_pool m_full_chunks;
+    chunk_pool m_empty_chunks;
+    std::atomic<size_t> m_size;
+    // pointers that did not fit into chunks after the arena has been exhausted
+    std::vector<byte*> m_overflow;
+    std::atomic<size_t> m_overflow_size;
+    mutex_t m_overflow_mutex;
     ssb_map_t m_ssb_map;
-    mutable mutex_t m_hashtable_mutex;
-    mutable mutex_t m_ssb_mutex;
+    mutex_t m_ssb_mutex;
 };
 
 }}}
@@ -25,7 +25,17 @@ public:
     size_t size() const;
 
     void trace(const gc_trace_callback& cb) const;
+
+    /**
+     * The set can be split into shards of at least MIN_SHARD_SIZE roots, which are traced independently.
+     * Shards are traced without the lock, so it is allowed only while the world is stopped
+     * (roots are registered inside gc-unsafe scope, thus nobody modifies the set at this time).
+     */
+    size_t shards_count(size_t max_shards) const;
+    void trace(const gc_trace_callback& cb, size_t shard, size_t shards_cnt) const;
 private:
+    static const size_t MIN_SHARD_SIZE = 1024;
+
     typedef std::mutex mutex_t;
 
     std::unordered_set<gc_handle*> m_set;
@@ -1,6 +1,9 @@
 #ifndef ALLOCGC_GC_CELL_HPP
 #define ALLOCGC_GC_CELL_HPP
 
+#include <functional>
+#include <utility>
+
 #include <liballocgc/details/allocators/gc_box.hpp>
 #include <liballocgc/details/allocators/gc_memory_descriptor.hpp>
 
@@ -71,6 +74,12 @@ public:
         m_descr->set_pin(m_cell, pin);
     }
 
+    bool try_mark() const
+    {
+        assert(is_initialized());
+        return m_descr->try_mark(m_cell);
+    }
+
     bool is_init() const
     {
         assert(is_initialized());
@@ -106,10 +115,20 @@ public:
         return m_descr->get_type_meta(m_cell);
     }
 
-    void trace(const gc_trace_callback& cb) const
+    // cells of the known descriptors are traced without virtual call and without wrapping visitor into std::function
+    template <typename Visitor>
+    void trace(Visitor&& visitor) const
     {
         assert(is_initialized());
-        m_descr->trace(m_cell, cb);
+        switch (m_descr->kind()) {
+            case allocators::gc_descriptor_kind::POOL:
+            case allocators::gc_descriptor_kind::OBJECT:
+                assert(m_descr->is_init(m_cell));
+                allocators::gc_box::trace(m_cell, std::forward<Visitor>(visitor));
+                break;
+            default:
+                m_descr->trace(m_cell, gc_trace_callback{std::ref(visitor)});
+        }
     }
 
     void move(const gc_cell& to) const
@@ -140,6 +159,8 @@ private:
     allocators::gc_memory_descriptor* m_descr;
 };
 
+typedef std::function<void(const gc_cell&)> gc_cell_callback;
+
 }}
 
 #endif //ALLOCGC_GC_CELL_HPP
@@ -124,6 +124,21 @@ public:
         strategy.set_heap_limit(limit);
     }
 
+    static void set_nursery_size(size_t size)
+    {
+        strategy.set_nursery_size(size);
+    }
+
+    static void set_sticky_marks(bool sticky)
+    {
+        strategy.set_sticky_marks(sticky);
+    }
+
+    static void set_local_heap_size(size_t size)
+    {
+        strategy.set_local_heap_size(size);
+    }
+
     static inline gc_stat stats()
     {
         return strategy.stats();
@@ -48,6 +48,9 @@ public:
 
     virtual gc_runstat gc(const gc_options& opt) = 0;
     virtual gc_info info() const = 0;
+
+    // called by allocators during the marking phase, so that incremental collector can do a slice of marking
+    virtual void mark_increment(size_t alloc_size) {}
 };
 
 inline const char* gc_kind_to_str(gc_kind type)
@@ -148,6 +148,16 @@ public:
         m_uninit_stack.trace(cb);
     }
 
+    bool is_stack_ptr(const gc_handle* ptr) const
+    {
+        return m_stack_descr.is_stack_ptr(ptr);
+    }
+
+    gc_heap::tlab* get_tlab() const
+    {
+        return m_tlab;
+    }
+
     std::thread::id get_id() const
     {
         return m_id;
@@ -0,0 +1,37 @@
+#ifndef ALLOCGC_NUMA_TOPOLOGY_HPP
+#define ALLOCGC_NUMA_TOPOLOGY_HPP
+
+#include <cstddef>
+
+#include <liballocgc/gc_common.hpp>
+
+namespace allocgc { namespace details { namespace threads {
+
+/**
+ * Topology of NUMA nodes of the machine.
+ *
+ * Topology can be faked (e.g. for testing on a single-node machine)
+ * by setting ALLOCGC_FAKE_NUMA_NODES environment variable or by calling set_fake_nodes_count.
+ * In fake mode threads are assigned to nodes in round-robin order and memory binding is no-op.
+ */
+class numa_topology
+{
+public:
+    static const size_t MAX_NODES_COUNT;
+
+    static size_t nodes_count();
+
+    // node of the cpu the calling thread is running on
+    static size_t current_node();
+
+    static bool is_fake();
+
+    // pass 0 to restore the real topology
+    static void set_fake_nodes_count(size_t count);
+
+    static void bind_memory(byte* ptr, size_t size, size_t node);
+};
+
+}}}
+
+#endif //ALLOCGC_NUMA_TOPOLOGY_HPP
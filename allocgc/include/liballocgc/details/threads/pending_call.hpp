@@ -1,6 +1,7 @@
 #ifndef ALLOCGC_PENDING_CALL_HPP
 #define ALLOCGC_PENDING_CALL_HPP
 
+#include <cassert>
 #include <csignal>
 #include <atomic>
 #include <array>
@@ -24,8 +25,27 @@ public:
 
     void operator()();
 
-    void enter_pending_scope();
-    void leave_pending_scope();
+    // pending scope is entered on each pointer store by the write barriers, so it is inline;
+    // signal fences keep the accesses made in the scope inside of it
+    void enter_pending_scope()
+    {
+        m_depth.store(m_depth.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    void leave_pending_scope()
+    {
+        assert(m_callable);
+        assert(m_depth > 0);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        size_t depth = m_depth.load(std::memory_order_relaxed);
+        if (depth == 1) {
+            m_depth.store(0, std::memory_order_relaxed);
+            call_if_pended();
+        } else {
+            m_depth.store(depth - 1, std::memory_order_relaxed);
+        }
+    }
     
     void enter_safe_scope();
     void leave_safe_scope();
@@ -34,7 +54,14 @@ public:
 private:
     static const size_t DEPTH_STACK_SIZE = 8;
 
-    void call_if_pended();
+    void call_if_pended()
+    {
+        if (m_pending_flag.load(std::memory_order_relaxed) == PENDING) {
+            call_pended();
+        }
+    }
+
+    void call_pended();
 
     static const size_t PENDING = 1;
     static const size_t NOT_PENDING = 0;
@@ -27,8 +27,15 @@ public:
 
     void send(pthread_t thread);
 
-    static void lock();
-    static void unlock();
+    static void lock()
+    {
+        pcall.enter_pending_scope();
+    }
+
+    static void unlock()
+    {
+        pcall.leave_pending_scope();
+    }
 
     static void enter_safe_scope();
     static void leave_safe_scope();
@@ -42,6 +49,10 @@ private:
 
     posix_signal();
 
+    // pending_call has a constexpr constructor and a trivial destructor, so with __thread
+    // the variable is constant initialized and lock/unlock access it without TLS wrapper calls
+    static __thread pending_call pcall;
+
     handler_type m_handler;
 };
 
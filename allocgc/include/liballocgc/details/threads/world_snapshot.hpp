@@ -74,6 +74,15 @@ public:
         }
     }
 
+    // calls the functor for the descriptor of each thread, e.g. to scan the threads in parallel
+    template <typename Functor>
+    void for_each_thread(Functor&& f) const
+    {
+        for (auto& thread: m_threads) {
+            f(static_cast<const gc_thread_descriptor*>(thread.get()));
+        }
+    }
+
     void trace_pins(const gc_trace_pin_callback& cb) const
     {
         for (auto& thread: m_threads) {
@@ -43,9 +43,11 @@ public:
         m_val &= mask;
     }
 
-    void fetch_or(ull mask)
+    ull fetch_or(ull mask)
     {
+        ull val = m_val;
         m_val |= mask;
+        return val;
     }
 
     void fetch_xor(ull mask)
@@ -82,9 +84,9 @@ public:
         m_val.fetch_and(mask, std::memory_order_acq_rel);
     }
 
-    void fetch_or(ull mask)
+    ull fetch_or(ull mask)
     {
-        m_val.fetch_or(mask, std::memory_order_acq_rel);
+        return m_val.fetch_or(mask, std::memory_order_acq_rel);
     }
 
     void fetch_xor(ull mask)
@@ -127,6 +129,13 @@ public:
         m_blocks[block_idx(i)].fetch_or(mask);
     }
 
+    // sets the bit and returns its previous value, for sync_bitset it is done in one atomic operation
+    bool test_and_set(size_t i)
+    {
+        ull mask = ONE << bit_offset(i);
+        return m_blocks[block_idx(i)].fetch_or(mask) & mask;
+    }
+
     void reset(size_t i)
     {
         ull mask = ONE << bit_offset(i);
@@ -0,0 +1,112 @@
+#ifndef ALLOCGC_CHASE_LEV_DEQUE_HPP
+#define ALLOCGC_CHASE_LEV_DEQUE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <atomic>
+#include <array>
+
+#include <liballocgc/details/utils/math.hpp>
+#include <liballocgc/details/utils/utility.hpp>
+
+namespace allocgc { namespace details { namespace utils {
+
+/**
+ * Chase-Lev work-stealing deque of pointers with fixed capacity
+ * (see "Correct and Efficient Work-Stealing for Weak Memory Models" by Le et al.).
+ *
+ * Only the owner thread can push and pop from the bottom, any thread can steal from the top.
+ * Capacity is fixed, so the owner should never push more than Capacity elements.
+ */
+template <typename T, size_t Capacity>
+class chase_lev_deque : private noncopyable, private nonmovable
+{
+    static_assert(check_pow2(Capacity), "Capacity should be a power of 2");
+public:
+    chase_lev_deque()
+        : m_top(0)
+        , m_bottom(0)
+    {
+        for (auto& item: m_items) {
+            item.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    // owner only
+    bool push(T* item)
+    {
+        std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+        std::int64_t t = m_top.load(std::memory_order_acquire);
+        if (b - t >= (std::int64_t) Capacity) {
+            return false;
+        }
+        m_items[b & MASK].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // owner only
+    T* pop()
+    {
+        std::int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = m_top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = m_items[b & MASK].load(std::memory_order_relaxed);
+        if (t == b) {
+            // last item, race with thieves
+            if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    T* steal()
+    {
+        std::int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = m_bottom.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return nullptr;
+        }
+
+        T* item = m_items[t & MASK].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    // approximation, can be used only as a hint by non-owner threads
+    bool empty() const
+    {
+        std::int64_t t = m_top.load(std::memory_order_acquire);
+        std::int64_t b = m_bottom.load(std::memory_order_acquire);
+        return t >= b;
+    }
+private:
+    static const std::int64_t MASK = Capacity - 1;
+
+    static const size_t CACHE_LINE_SIZE = 64;
+
+    // top and bottom are kept apart, since they are modified by different threads
+    std::atomic<std::int64_t> m_top;
+    char m_padding[CACHE_LINE_SIZE - sizeof(std::atomic<std::int64_t>)];
+    std::atomic<std::int64_t> m_bottom;
+    std::array<std::atomic<T*>, Capacity> m_items;
+};
+
+}}}
+
+#endif //ALLOCGC_CHASE_LEV_DEQUE_HPP
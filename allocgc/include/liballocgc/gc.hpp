@@ -11,7 +11,10 @@
 #include <liballocgc/details/threads/posix_thread.hpp>
 #include <liballocgc/details/threads/return_address.hpp>
 #include <liballocgc/details/collectors/gc_cms.hpp>
+#include <liballocgc/details/collectors/gc_satb.hpp>
 #include <liballocgc/details/collectors/gc_serial.hpp>
+#include <liballocgc/details/collectors/gc_generational.hpp>
+#include <liballocgc/details/collectors/gc_thread_local.hpp>
 
 
 namespace allocgc {
@@ -136,6 +139,196 @@ std::thread create_thread(F&& f, Args&&... args)
 
 }
 
+namespace satb {
+
+template <typename T>
+using gc_ptr = pointers::gc_ptr<T, details::collectors::gc_satb>;
+
+template <typename T>
+using gc_pin = pointers::gc_pin<T, details::collectors::gc_satb>;
+
+template <typename T>
+using gc_ref = pointers::gc_ref<T, details::collectors::gc_satb>;
+
+template <typename T, typename... Args>
+auto gc_new(Args&&... args)
+-> decltype(pointers::gc_new<T, details::collectors::gc_satb>(std::forward<Args>(args)...))
+{
+    return pointers::gc_new<T, details::collectors::gc_satb>(std::forward<Args>(args)...);
+};
+
+template <typename T>
+auto gc_new(size_t n)
+-> decltype(pointers::gc_new<T, details::collectors::gc_satb>(n))
+{
+    return pointers::gc_new<T, details::collectors::gc_satb>(n);
+};
+
+void gc();
+
+gc_stat stats();
+
+void set_heap_limit(size_t limit);
+void set_threads_available(size_t threads_available);
+
+void register_main_thread();
+void register_thread(const thread_descriptor& descr);
+void deregister_thread(std::thread::id id);
+
+template <typename F, typename... Args>
+std::thread create_thread(F&& f, Args&&... args)
+{
+    using namespace details::threads;
+
+    typedef decltype(std::bind(std::forward<F>(f), std::forward<Args>(args)...)) functor_type;
+
+    return std::thread([] (std::unique_ptr<functor_type> bf) {
+
+        thread_descriptor thrd_descr;
+        thrd_descr.id = std::this_thread::get_id();
+        thrd_descr.native_handle = details::threads::this_thread_native_handle();
+        thrd_descr.stack_addr = get_stack_addr(this_thread_native_handle());
+        thrd_descr.stack_size = get_stack_size(this_thread_native_handle());
+
+        register_thread(thrd_descr);
+        (*bf)();
+        deregister_thread(std::this_thread::get_id());
+    }, std::unique_ptr<functor_type>(new functor_type(std::bind(std::forward<F>(f), std::forward<Args>(args)...))));
+};
+
+}
+
+namespace gen {
+
+template <typename T>
+using gc_ptr = pointers::gc_ptr<T, details::collectors::gc_generational>;
+
+template <typename T>
+using gc_pin = pointers::gc_pin<T, details::collectors::gc_generational>;
+
+template <typename T>
+using gc_ref = pointers::gc_ref<T, details::collectors::gc_generational>;
+
+template <typename T, typename... Args>
+auto gc_new(Args&&... args)
+-> decltype(pointers::gc_new<T, details::collectors::gc_generational>(std::forward<Args>(args)...))
+{
+    return pointers::gc_new<T, details::collectors::gc_generational>(std::forward<Args>(args)...);
+};
+
+template <typename T>
+auto gc_new(size_t n)
+-> decltype(pointers::gc_new<T, details::collectors::gc_generational>(n))
+{
+    return pointers::gc_new<T, details::collectors::gc_generational>(n);
+};
+
+// collects the whole heap
+void gc();
+// collects only the nursery
+void minor_gc();
+
+gc_stat stats();
+
+void set_heap_limit(size_t limit);
+// allocation budget of the young generation between two collections
+void set_nursery_size(size_t size);
+// non-moving mode in which marks of the survivors are kept until the major collection;
+// should be called before the first thread is registered
+void set_sticky_marks(bool sticky);
+void set_threads_available(size_t threads_available);
+
+void register_main_thread();
+void register_thread(const thread_descriptor& descr);
+void deregister_thread(std::thread::id id);
+
+template <typename F, typename... Args>
+std::thread create_thread(F&& f, Args&&... args)
+{
+    using namespace details::threads;
+
+    typedef decltype(std::bind(std::forward<F>(f), std::forward<Args>(args)...)) functor_type;
+
+    return std::thread([] (std::unique_ptr<functor_type> bf) {
+
+        thread_descriptor thrd_descr;
+        thrd_descr.id = std::this_thread::get_id();
+        thrd_descr.native_handle = details::threads::this_thread_native_handle();
+        thrd_descr.stack_addr = get_stack_addr(this_thread_native_handle());
+        thrd_descr.stack_size = get_stack_size(this_thread_native_handle());
+
+        register_thread(thrd_descr);
+        (*bf)();
+        deregister_thread(std::this_thread::get_id());
+    }, std::unique_ptr<functor_type>(new functor_type(std::bind(std::forward<F>(f), std::forward<Args>(args)...))));
+};
+
+}
+
+namespace tlh {
+
+template <typename T>
+using gc_ptr = pointers::gc_ptr<T, details::collectors::gc_thread_local>;
+
+template <typename T>
+using gc_pin = pointers::gc_pin<T, details::collectors::gc_thread_local>;
+
+template <typename T>
+using gc_ref = pointers::gc_ref<T, details::collectors::gc_thread_local>;
+
+template <typename T, typename... Args>
+auto gc_new(Args&&... args)
+-> decltype(pointers::gc_new<T, details::collectors::gc_thread_local>(std::forward<Args>(args)...))
+{
+    return pointers::gc_new<T, details::collectors::gc_thread_local>(std::forward<Args>(args)...);
+};
+
+template <typename T>
+auto gc_new(size_t n)
+-> decltype(pointers::gc_new<T, details::collectors::gc_thread_local>(n))
+{
+    return pointers::gc_new<T, details::collectors::gc_thread_local>(n);
+};
+
+// collects the whole heap
+void gc();
+// collects only the thread-local heap of the calling thread, the rest of the threads keep running
+void local_gc();
+
+gc_stat stats();
+
+void set_heap_limit(size_t limit);
+// allocation budget of the thread-local heap between two collections, applies to the threads registered after the call
+void set_local_heap_size(size_t size);
+void set_threads_available(size_t threads_available);
+
+void register_main_thread();
+void register_thread(const thread_descriptor& descr);
+void deregister_thread(std::thread::id id);
+
+template <typename F, typename... Args>
+std::thread create_thread(F&& f, Args&&... args)
+{
+    using namespace details::threads;
+
+    typedef decltype(std::bind(std::forward<F>(f), std::forward<Args>(args)...)) functor_type;
+
+    return std::thread([] (std::unique_ptr<functor_type> bf) {
+
+        thread_descriptor thrd_descr;
+        thrd_descr.id = std::this_thread::get_id();
+        thrd_descr.native_handle = details::threads::this_thread_native_handle();
+        thrd_descr.stack_addr = get_stack_addr(this_thread_native_handle());
+        thrd_descr.stack_size = get_stack_size(this_thread_native_handle());
+
+        register_thread(thrd_descr);
+        (*bf)();
+        deregister_thread(std::this_thread::get_id());
+    }, std::unique_ptr<functor_type>(new functor_type(std::bind(std::forward<F>(f), std::forward<Args>(args)...))));
+};
+
+}
+
 }
 
 #endif //ALLOCGC_GC_H
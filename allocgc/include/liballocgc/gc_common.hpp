@@ -3,6 +3,9 @@
 
 #include <thread>
 #include <atomic>
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <vector>
 
 #include <boost/range/iterator_range.hpp>
@@ -135,11 +138,46 @@ struct gc_memstat
     }
 };
 
+// histogram of the pause times, the bounds of the buckets grow by the power of two
+struct gc_pause_histogram
+{
+    static const size_t BUCKETS_COUNT = 16;
+
+    size_t              count   = 0;
+    gc_clock::duration  total   = gc_clock::duration(0);
+    gc_clock::duration  longest = gc_clock::duration(0);
+    // i-th bucket counts the pauses shorter than bucket_bound(i), the last one counts all the rest
+    std::array<size_t, BUCKETS_COUNT> buckets = std::array<size_t, BUCKETS_COUNT>();
+
+    static gc_clock::duration bucket_bound(size_t i)
+    {
+        return i + 1 < BUCKETS_COUNT
+               ? gc_clock::duration(std::chrono::microseconds(100) * (1 << i))
+               : gc_clock::duration::max();
+    }
+
+    void add(gc_clock::duration pause)
+    {
+        ++count;
+        total += pause;
+        longest = std::max(longest, pause);
+        size_t i = 0;
+        while (i + 1 < BUCKETS_COUNT && pause >= bucket_bound(i)) {
+            ++i;
+        }
+        ++buckets[i];
+    }
+};
+
 struct gc_stat
 {
     size_t              gc_count;
     gc_clock::duration  gc_time;
     gc_memstat          gc_mem;
+    size_t              mark_mem;   // total size of cells traced by the marker
+    gc_clock::duration  mark_time;  // total wall-clock time of marking
+    gc_pause_histogram  minor_pauses;   // pauses of the young generation collections
+    gc_pause_histogram  major_pauses;   // pauses of the whole heap collections
 };
 
 struct gc_collect_stat
@@ -171,6 +209,8 @@ struct gc_collect_stat
 struct gc_runstat
 {
     gc_clock::duration  pause = gc_clock::duration(0);
+    // the oldest collected generation, -1 means the whole heap
+    gc_gen              gen   = -1;
     gc_collect_stat     collection;
 };
 
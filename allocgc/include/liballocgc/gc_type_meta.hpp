@@ -2,6 +2,7 @@
 #define ALLOCGC_GC_TYPE_META_HPP
 
 #include <vector>
+#include <cstdint>
 #include <type_traits>
 
 #include <boost/range/iterator_range.hpp>
@@ -46,6 +47,17 @@ public:
         return boost::make_iterator_range(m_offsets.cbegin(), m_offsets.cend());
     }
 
+    /**
+     * Bit i of the mask is set if there is a pointer at offset i * sizeof(gc_handle) of the object.
+     * Objects are traced by the mask instead of the offsets vector, so no offsets are loaded from memory.
+     *
+     * The mask is zero if the object has no pointers or some of them do not fit into the mask.
+     */
+    inline std::uint64_t pointers_mask() const noexcept
+    {
+        return m_pointers_mask;
+    }
+
     inline bool is_movable() const noexcept
     {
         return m_is_movable;
@@ -61,15 +73,68 @@ protected:
                  Iter offsets_first,
                  Iter offsets_last)
         : m_offsets(offsets_first, offsets_last)
+        , m_pointers_mask(make_pointers_mask(m_offsets))
         , m_type_size(type_size)
         , m_is_movable(is_movable)
     {}
 private:
+    static const size_t MASK_BITS = 64;
+
+    static std::uint64_t make_pointers_mask(const offset_container_t& offsets)
+    {
+        std::uint64_t mask = 0;
+        for (size_t offset: offsets) {
+            if (offset % sizeof(gc_handle) != 0 || offset / sizeof(gc_handle) >= MASK_BITS) {
+                return 0;
+            }
+            mask |= (std::uint64_t) 1 << (offset / sizeof(gc_handle));
+        }
+        return mask;
+    }
+
     offset_container_t m_offsets;
+    std::uint64_t m_pointers_mask;
     size_t m_type_size;
     bool m_is_movable;
 };
 
+/**
+ * Layout of the type is discovered at runtime during the first allocation of the type.
+ * For the types with layout known at compile time it can be declared up front (see ALLOCGC_DECLARE_TYPE_LAYOUT),
+ * then the type meta is created from the declared offsets and runtime discovery is skipped.
+ */
+template <typename T>
+struct gc_type_layout
+{
+    static const bool declared = false;
+
+    static std::vector<size_t> offsets()
+    {
+        return std::vector<size_t>();
+    }
+};
+
+/**
+ * Declares offsets of the pointer fields of the type, e.g.
+ *
+ *      ALLOCGC_DECLARE_TYPE_LAYOUT(node, offsetof(node, left), offsetof(node, right))
+ *
+ * Should be used in the global namespace.
+ */
+#define ALLOCGC_DECLARE_TYPE_LAYOUT(T, ...)                 \
+    namespace allocgc {                                     \
+    template <>                                             \
+    struct gc_type_layout<T>                                \
+    {                                                       \
+        static const bool declared = true;                  \
+                                                            \
+        static std::vector<size_t> offsets()                \
+        {                                                   \
+            return std::vector<size_t>({__VA_ARGS__});      \
+        }                                                   \
+    };                                                      \
+    }
+
 template <typename T>
 class gc_type_meta_factory;
 
@@ -124,7 +189,11 @@ class gc_type_meta_factory : private details::utils::nonconstructible
 public:
     static const gc_type_meta* get()
     {
-        return meta.load(std::memory_order_acquire);
+        const gc_type_meta* type_meta = meta.load(std::memory_order_acquire);
+        if (!type_meta && gc_type_layout<T>::declared) {
+            return create(gc_type_layout<T>::offsets());
+        }
+        return type_meta;
     }
 
     static const gc_type_meta* create()
@@ -144,7 +213,7 @@ public:
     {
         static_assert(std::is_same<typename Iter::value_type, size_t>::value, "Offsets should have size_t type");
 
-        const gc_type_meta* type_meta = get();
+        const gc_type_meta* type_meta = meta.load(std::memory_order_acquire);
         if (type_meta != nullptr) {
             return type_meta;
         }
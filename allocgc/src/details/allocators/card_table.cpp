@@ -0,0 +1,41 @@
+#include <liballocgc/details/allocators/card_table.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/mman.h>
+
+#include <liballocgc/details/logging.hpp>
+
+namespace allocgc { namespace details { namespace allocators {
+
+void card_table::init(const byte* base, size_t size)
+{
+    assert(!m_cards);
+    assert(reinterpret_cast<std::uintptr_t>(base) % PAGE_SIZE == 0);
+    assert(size % CARD_SIZE == 0);
+    assert(card_t().is_lock_free());
+
+    size_t table_size = (size >> CARD_SIZE_LOG2) * sizeof(card_t);
+    void* cards = mmap(nullptr, table_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (cards == MAP_FAILED) {
+        logging::warning() << "card table mmap failed: " << strerror(errno);
+        return;
+    }
+
+    // zeroed memory is a table of clean cards
+    m_cards = reinterpret_cast<card_t*>(cards);
+    m_base  = reinterpret_cast<std::uintptr_t>(base);
+    m_size  = size;
+}
+
+void card_table::clear()
+{
+    size_t used_size = m_used_size.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < used_size; ++i) {
+        m_cards[i].store(CLEAN, std::memory_order_relaxed);
+    }
+}
+
+}}}
@@ -12,12 +12,17 @@ const double gc_core_allocator::MARK_THRESHOLD = 0.6;
 
 const double gc_core_allocator::COLLECT_THRESHOLD = 1.0;
 
+const size_t gc_core_allocator::MARK_INCREMENT_PERIOD = 64 * 1024;
+
 gc_core_allocator::gc_core_allocator()
     : m_gc_launcher(nullptr)
     , m_heap_size(0)
     , m_heap_limit(HEAP_START_LIMIT)
     , m_heap_maxlimit(std::numeric_limits<size_t>::max())
+    , m_pools(threads::numa_topology::nodes_count())
+    , m_mark_trigger(MARK_THRESHOLD)
     , m_mark_threshold(false)
+    , m_mark_increment_size(0)
 { }
 
 gc_core_allocator::gc_core_allocator(gc_launcher* gc)
@@ -25,50 +30,75 @@ gc_core_allocator::gc_core_allocator(gc_launcher* gc)
     , m_heap_size(0)
     , m_heap_limit(HEAP_START_LIMIT)
     , m_heap_maxlimit(std::numeric_limits<size_t>::max())
+    , m_pools(threads::numa_topology::nodes_count())
+    , m_mark_trigger(MARK_THRESHOLD)
+    , m_mark_threshold(false)
+    , m_mark_increment_size(0)
 { }
 
-byte* gc_core_allocator::allocate(size_t size)
+byte* gc_core_allocator::allocate(size_t size, size_t numa_node)
 {
     assert(size != 0);
     size_t aligned_size = sys_allocator::align_size(size);
 
-    std::unique_lock<mutex_t> lock(m_mutex);
-
-    if (!increase_heap_size(aligned_size, &lock)) {
+    if (!increase_heap_size(aligned_size)) {
         return nullptr;
     }
 
+    // topology could be changed (faked) after allocator has been created
+    numa_node %= m_pools.size();
+
     byte* page = nullptr;
     if (aligned_size <= MAX_BUCKETIZE_SIZE) {
-        page = m_bucket_alloc.allocate(aligned_size);
+        node_page_pool& pool = m_pools[numa_node];
+        {
+            std::lock_guard<mutex_t> lock(pool.m_mutex);
+            page = pool.m_bucket_alloc.allocate(aligned_size);
+        }
+        threads::numa_topology::bind_memory(page, aligned_size, numa_node);
         memset(page, 0, aligned_size);
     } else {
-        page = sys_allocator::allocate(aligned_size);
+        page = reserved_range_allocator::allocate(aligned_size);
+        threads::numa_topology::bind_memory(page, aligned_size, numa_node);
     }
     return page;
 }
 
-void gc_core_allocator::deallocate(byte* ptr, size_t size)
+void gc_core_allocator::deallocate(byte* ptr, size_t size, size_t numa_node)
 {
     assert(size != 0);
+    deallocate_pages(ptr, size, numa_node);
+    decrease_heap_size(sys_allocator::align_size(size));
+}
 
-    std::lock_guard<mutex_t> lock(m_mutex);
+void gc_core_allocator::deallocate_pages(byte* ptr, size_t size, size_t numa_node)
+{
+    assert(size != 0);
 
     size_t aligned_size = sys_allocator::align_size(size);
 
+    node_page_pool& pool = m_pools[numa_node % m_pools.size()];
+    std::lock_guard<mutex_t> lock(pool.m_mutex);
     if (aligned_size <= MAX_BUCKETIZE_SIZE) {
-        m_bucket_alloc.deallocate(ptr, aligned_size);
+        pool.m_bucket_alloc.deallocate(ptr, aligned_size);
     } else {
-        m_freelist.deallocate(ptr, aligned_size);
+        pool.m_freelist.deallocate(ptr, aligned_size);
     }
-
-    decrease_heap_size(aligned_size);
 }
 
 size_t gc_core_allocator::shrink()
 {
-    std::lock_guard<mutex_t> lock(m_mutex);
-    return m_freelist.shrink();
+    size_t shrunk = 0;
+    for (auto& pool: m_pools) {
+        std::lock_guard<mutex_t> lock(pool.m_mutex);
+        shrunk += pool.m_freelist.shrink();
+    }
+    return shrunk;
+}
+
+size_t gc_core_allocator::numa_nodes_count() const
+{
+    return m_pools.size();
 }
 
 gc_core_allocator::memory_range_type gc_core_allocator::memory_range()
@@ -76,52 +106,66 @@ gc_core_allocator::memory_range_type gc_core_allocator::memory_range()
     return memory_range_type(nullptr, nullptr);
 }
 
-bool gc_core_allocator::increase_heap_size(size_t alloc_size, std::unique_lock<mutex_t>* lock)
+bool gc_core_allocator::increase_heap_size(size_t alloc_size)
 {
-    size_t size = m_heap_size + alloc_size;
-    if (size > COLLECT_THRESHOLD * m_heap_limit) {
-        return false;
-    }
-    else if (!m_mark_threshold && m_gc_launcher && m_gc_launcher->info().incremental_flag
-             && size > MARK_THRESHOLD * m_heap_limit) {
-        m_mark_threshold = true;
-
+    size_t heap_size = m_heap_size.load(std::memory_order_relaxed);
+    size_t heap_limit;
+    do {
+        heap_limit = m_heap_limit.load(std::memory_order_relaxed);
+        if (heap_size + alloc_size > COLLECT_THRESHOLD * heap_limit) {
+            return false;
+        }
+    } while (!m_heap_size.compare_exchange_weak(heap_size, heap_size + alloc_size, std::memory_order_relaxed));
+
+    if (m_gc_launcher && heap_size + alloc_size > m_mark_trigger.load(std::memory_order_relaxed) * heap_limit
+        && !m_mark_threshold.load(std::memory_order_relaxed) && m_gc_launcher->info().incremental_flag
+        && !m_mark_threshold.exchange(true, std::memory_order_relaxed)) {
         gc_options opt;
         opt.kind = gc_kind::LAUNCH_CONCURRENT_MARK;
         opt.gen  = 0;
 
-        lock->unlock();
         m_gc_launcher->gc(opt);
-        lock->lock();
     }
-    m_heap_size += alloc_size;
     return true;
 }
 
 void gc_core_allocator::decrease_heap_size(size_t size)
 {
-    m_heap_size -= size;
+    m_heap_size.fetch_sub(size, std::memory_order_relaxed);
+}
+
+size_t gc_core_allocator::heap_size() const
+{
+    return m_heap_size.load(std::memory_order_relaxed);
+}
+
+size_t gc_core_allocator::heap_limit() const
+{
+    return m_heap_limit.load(std::memory_order_relaxed);
+}
+
+void gc_core_allocator::set_mark_trigger(double trigger)
+{
+    m_mark_trigger.store(trigger, std::memory_order_relaxed);
 }
 
 void gc_core_allocator::set_heap_limit(size_t limit)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_heap_limit = limit;
+    m_heap_limit.store(limit, std::memory_order_relaxed);
 //    m_heap_maxlimit = limit;
 }
 
 void gc_core_allocator::expand_heap(double increase_factor)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    size_t increased_size = increase_factor * m_heap_limit;
-    m_heap_limit = std::min(increased_size, m_heap_maxlimit);
-    m_mark_threshold = false;
+    size_t increased_size = increase_factor * m_heap_limit.load(std::memory_order_relaxed);
+    m_heap_limit.store(std::min(increased_size, m_heap_maxlimit), std::memory_order_relaxed);
+    m_mark_threshold.store(false, std::memory_order_relaxed);
 }
 
 void gc_core_allocator::notify_gc()
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_mark_threshold = false;
+    m_mark_threshold.store(false, std::memory_order_relaxed);
+    m_mark_increment_size.store(0, std::memory_order_relaxed);
 }
 
 gc_runstat gc_core_allocator::gc(const gc_options& options)
@@ -130,6 +174,21 @@ gc_runstat gc_core_allocator::gc(const gc_options& options)
     return m_gc_launcher->gc(options);
 }
 
+void gc_core_allocator::mark_increment(size_t alloc_size)
+{
+    // marking phase has been launched only if mark threshold is set
+    if (!m_gc_launcher || !m_mark_threshold.load(std::memory_order_relaxed)) {
+        return;
+    }
+    size_t increment_size = m_mark_increment_size.fetch_add(alloc_size, std::memory_order_relaxed) + alloc_size;
+    if (increment_size >= MARK_INCREMENT_PERIOD) {
+        increment_size = m_mark_increment_size.exchange(0, std::memory_order_relaxed);
+        if (increment_size > 0) {
+            m_gc_launcher->mark_increment(increment_size);
+        }
+    }
+}
+
 size_t gc_core_allocator::page_bucket_policy::bucket(size_t size)
 {
     return (size >> PAGE_SIZE_LOG2) - 1;
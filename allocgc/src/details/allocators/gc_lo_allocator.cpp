@@ -22,12 +22,13 @@ gc_lo_allocator::~gc_lo_allocator()
 gc_alloc::response gc_lo_allocator::allocate(const gc_alloc::request& rqst)
 {
     size_t blk_size = get_blk_size(rqst.alloc_size());
+    size_t numa_node = threads::numa_topology::current_node();
 
-    auto deleter = [this, blk_size] (byte* ptr) {
+    auto deleter = [this, blk_size, numa_node] (byte* ptr) {
         std::lock_guard<mutex_t> lock(m_mutex);
-        deallocate_blk(ptr, blk_size);
+        deallocate_blk(ptr, blk_size, numa_node);
     };
-    std::unique_ptr<byte, decltype(deleter)> blk(allocate_blk(blk_size), deleter);
+    std::unique_ptr<byte, decltype(deleter)> blk(allocate_blk(blk_size, numa_node), deleter);
 
     if (!blk) {
         gc_options opt;
@@ -36,10 +37,10 @@ gc_alloc::response gc_lo_allocator::allocate(const gc_alloc::request& rqst)
 
         m_alloc.upstream_allocator().allocator()->gc(opt);
 
-        blk.reset(allocate_blk(blk_size));
+        blk.reset(allocate_blk(blk_size, numa_node));
         if (!blk) {
             m_alloc.upstream_allocator().allocator()->expand_heap();
-            blk.reset(allocate_blk(blk_size));
+            blk.reset(allocate_blk(blk_size, numa_node));
             if (!blk) {
                 throw gc_bad_alloc();
             }
@@ -47,7 +48,7 @@ gc_alloc::response gc_lo_allocator::allocate(const gc_alloc::request& rqst)
     }
 
     descriptor_t* descr = get_descr(blk.get());
-    new (descr) descriptor_t(rqst.alloc_size());
+    new (descr) descriptor_t(rqst.alloc_size(), numa_node);
 
     byte*  cell_start = get_memblk(blk.get());
     size_t cell_size  = get_cell_size(rqst.alloc_size());
@@ -60,6 +61,8 @@ gc_alloc::response gc_lo_allocator::allocate(const gc_alloc::request& rqst)
 
     blk.release();
 
+    m_alloc.upstream_allocator().allocator()->mark_increment(blk_size);
+
     return gc_alloc::response(obj_start, cell_start, cell_size, rqst.buffer());
 }
 
@@ -97,6 +100,22 @@ void gc_lo_allocator::finalize()
     }
 }
 
+void gc_lo_allocator::unpin()
+{
+    for (auto it = descriptors_begin(); it != descriptors_end(); ++it) {
+        it->set_pin(false);
+    }
+}
+
+void gc_lo_allocator::trace_live(const gc_cell_callback& cb)
+{
+    for (auto it = memory_begin(); it != memory_end(); ++it) {
+        if (it->get_lifetime_tag() == gc_lifetime_tag::LIVE) {
+            cb(*it);
+        }
+    }
+}
+
 gc_memstat gc_lo_allocator::stats()
 {
     gc_memstat stat;
@@ -111,8 +130,9 @@ gc_memstat gc_lo_allocator::stats()
 
 void gc_lo_allocator::destroy(const descriptor_iterator& it)
 {
-    byte*  blk      = get_blk_by_descr(&(*it));
-    size_t blk_size = get_blk_size(it->cell_size());
+    byte*  blk       = get_blk_by_descr(&(*it));
+    size_t blk_size  = get_blk_size(it->cell_size());
+    size_t numa_node = it->numa_node();
 
     byte* memblk = get_memblk(blk);
     #ifdef WITH_DESTRUCTORS
@@ -120,18 +140,18 @@ void gc_lo_allocator::destroy(const descriptor_iterator& it)
     #endif
     memory_index::deindex(align_by_page(blk), m_alloc.get_blk_size(blk_size));
     it->~descriptor_t();
-    deallocate_blk(blk, blk_size);
+    deallocate_blk(blk, blk_size, numa_node);
 }
 
-byte* gc_lo_allocator::allocate_blk(size_t size)
+byte* gc_lo_allocator::allocate_blk(size_t size, size_t numa_node)
 {
     std::lock_guard<mutex_t> lock(m_mutex);
-    return m_alloc.allocate(size);
+    return m_alloc.allocate(size, numa_node);
 }
 
-void gc_lo_allocator::deallocate_blk(byte* ptr, size_t size)
+void gc_lo_allocator::deallocate_blk(byte* ptr, size_t size, size_t numa_node)
 {
-    m_alloc.deallocate(ptr, size);
+    m_alloc.deallocate(ptr, size, numa_node);
 }
 
 gc_lo_allocator::descriptor_iterator gc_lo_allocator::descriptors_begin()
@@ -0,0 +1,38 @@
+#include <liballocgc/details/allocators/gc_nursery.hpp>
+
+namespace allocgc { namespace details { namespace allocators {
+
+const size_t gc_nursery::DEFAULT_SIZE = 4 * 1024 * 1024;
+
+gc_nursery::gc_nursery(size_t size)
+    : m_size(size)
+    , m_allocated(0)
+{}
+
+bool gc_nursery::reserve(size_t size)
+{
+    size_t allocated = m_allocated.fetch_add(size, std::memory_order_relaxed);
+    return allocated == 0 || allocated + size <= m_size.load(std::memory_order_relaxed);
+}
+
+void gc_nursery::reset()
+{
+    m_allocated.store(0, std::memory_order_relaxed);
+}
+
+size_t gc_nursery::size() const
+{
+    return m_size.load(std::memory_order_relaxed);
+}
+
+void gc_nursery::set_size(size_t size)
+{
+    m_size.store(size, std::memory_order_relaxed);
+}
+
+size_t gc_nursery::allocated() const
+{
+    return m_allocated.load(std::memory_order_relaxed);
+}
+
+}}}
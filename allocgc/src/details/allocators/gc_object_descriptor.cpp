@@ -6,10 +6,13 @@
 
 namespace allocgc { namespace details { namespace allocators {
 
-gc_object_descriptor::gc_object_descriptor(size_t size)
-    : m_size(size)
+gc_object_descriptor::gc_object_descriptor(size_t size, size_t numa_node)
+    : gc_memory_descriptor(gc_descriptor_kind::OBJECT)
+    , m_size(size)
+    , m_numa_node(numa_node)
     , m_mark_bit(false)
     , m_pin_bit(false)
+    , m_init_bit(false)
 { }
 
 gc_object_descriptor::~gc_object_descriptor()
@@ -17,7 +20,7 @@ gc_object_descriptor::~gc_object_descriptor()
 
 bool gc_object_descriptor::get_mark() const noexcept
 {
-    return m_mark_bit;
+    return m_mark_bit.load(std::memory_order_relaxed);
 }
 
 bool gc_object_descriptor::get_pin() const noexcept
@@ -27,7 +30,7 @@ bool gc_object_descriptor::get_pin() const noexcept
 
 bool gc_object_descriptor::set_mark(bool mark) noexcept
 {
-    m_mark_bit = mark;
+    m_mark_bit.store(mark, std::memory_order_relaxed);
 }
 
 bool gc_object_descriptor::set_pin(bool pin) noexcept
@@ -38,7 +41,7 @@ bool gc_object_descriptor::set_pin(bool pin) noexcept
 bool gc_object_descriptor::get_mark(byte* ptr) const
 {
     assert(ptr == cell_start());
-    return m_mark_bit;
+    return m_mark_bit.load(std::memory_order_relaxed);
 }
 
 bool gc_object_descriptor::get_pin(byte* ptr) const
@@ -50,7 +53,7 @@ bool gc_object_descriptor::get_pin(byte* ptr) const
 void gc_object_descriptor::set_mark(byte* ptr, bool mark)
 {
     assert(ptr == cell_start());
-    m_mark_bit = mark;
+    m_mark_bit.store(mark, std::memory_order_relaxed);
 }
 
 void gc_object_descriptor::set_pin(byte* ptr, bool pin)
@@ -59,6 +62,12 @@ void gc_object_descriptor::set_pin(byte* ptr, bool pin)
     m_pin_bit = pin;
 }
 
+bool gc_object_descriptor::try_mark(byte* ptr)
+{
+    assert(ptr == cell_start());
+    return !m_mark_bit.load(std::memory_order_relaxed) && !m_mark_bit.exchange(true, std::memory_order_acq_rel);
+}
+
 bool gc_object_descriptor::is_init(byte* ptr) const
 {
     assert(ptr == cell_start());
@@ -68,7 +77,7 @@ bool gc_object_descriptor::is_init(byte* ptr) const
 gc_lifetime_tag gc_object_descriptor::get_lifetime_tag(byte* ptr) const
 {
     assert(ptr == cell_start());
-    return get_lifetime_tag_by_bits(m_mark_bit, m_init_bit);
+    return get_lifetime_tag_by_bits(m_mark_bit.load(std::memory_order_relaxed), m_init_bit);
 }
 
 size_t gc_object_descriptor::cell_size() const
@@ -141,7 +150,7 @@ void gc_object_descriptor::move(byte* to, byte* from, gc_memory_descriptor* from
     assert(from_descr->get_lifetime_tag(from) == gc_lifetime_tag::LIVE);
     gc_box::move(to, from, from_descr->object_count(from), from_descr->get_type_meta(from));
     from_descr->set_mark(from, false);
-    m_mark_bit = true;
+    m_mark_bit.store(true, std::memory_order_relaxed);
     m_init_bit = true;
 }
 
@@ -163,4 +172,9 @@ bool gc_object_descriptor::check_ptr(byte* ptr) const
     return (cell_start() <= ptr) && (ptr < cell_start() + m_size);
 }
 
+size_t gc_object_descriptor::numa_node() const
+{
+    return m_numa_node;
+}
+
 }}}
@@ -7,6 +7,7 @@
 #include <liballocgc/details/gc_facade.hpp>
 #include <liballocgc/details/allocators/gc_box.hpp>
 #include <liballocgc/details/allocators/memory_index.hpp>
+#include <liballocgc/details/utils/math.hpp>
 #include <liballocgc/details/compacting/fix_ptrs.hpp>
 #include <liballocgc/details/compacting/two_finger_compactor.hpp>
 #include <liballocgc/details/collectors/gc_new_stack_entry.hpp>
@@ -15,9 +16,14 @@ namespace allocgc { namespace details { namespace allocators {
 
 gc_pool_allocator::gc_pool_allocator()
     : m_core_alloc(nullptr)
+    , m_numa_node(0)
+    , m_nursery(nullptr)
+    , m_young(false)
     , m_freelist(nullptr)
     , m_top(nullptr)
     , m_end(nullptr)
+    , m_chunk_cache(nullptr)
+    , m_chunk_cache_size(0)
     , m_prev_residency(0)
 {}
 
@@ -26,6 +32,7 @@ gc_pool_allocator::~gc_pool_allocator()
     for (auto it = m_descrs.begin(); it != m_descrs.end(); ) {
         it = destroy_descriptor(it);
     }
+    flush_chunk_cache();
 }
 
 gc_core_allocator* gc_pool_allocator::get_core_allocator() const
@@ -38,6 +45,36 @@ void gc_pool_allocator::set_core_allocator(gc_core_allocator* core_alloc)
     m_core_alloc = core_alloc;
 }
 
+size_t gc_pool_allocator::get_numa_node() const
+{
+    return m_numa_node;
+}
+
+void gc_pool_allocator::set_numa_node(size_t numa_node)
+{
+    m_numa_node = numa_node;
+}
+
+gc_nursery* gc_pool_allocator::get_nursery() const
+{
+    return m_nursery;
+}
+
+void gc_pool_allocator::set_nursery(gc_nursery* nursery)
+{
+    m_nursery = nursery;
+}
+
+bool gc_pool_allocator::is_young() const
+{
+    return m_young;
+}
+
+void gc_pool_allocator::set_young(bool young)
+{
+    m_young = young;
+}
+
 gc_alloc::response gc_pool_allocator::allocate(const gc_alloc::request& rqst, size_t aligned_size)
 {
     if (m_top == m_end) {
@@ -53,15 +90,20 @@ gc_alloc::response gc_pool_allocator::try_expand_and_allocate(
 ) {
     using namespace collectors;
 
-    byte*  blk;
-    size_t blk_size;
-    std::tie(blk, blk_size) = allocate_block(size);
+    byte*  blk = nullptr;
+    size_t blk_size = 0;
+    // when the nursery is exhausted young chunk is allocated only after the collection
+    if (!m_nursery || m_nursery->reserve(descriptor_t::chunk_size(size)) || attempt_num > 0) {
+        std::tie(blk, blk_size) = allocate_block(size);
+    }
     if (blk) {
-        create_descriptor(blk, blk_size, size);
+        create_descriptor(blk, blk_size, size)->set_fresh(true);
         m_top = blk;
         m_end = blk + blk_size;
+        m_core_alloc->mark_increment(blk_size);
         return stack_allocation(size, rqst);
     } else if (m_freelist) {
+        m_core_alloc->mark_increment(size);
         return freelist_allocation(size, rqst);
     } else {
         if (attempt_num == 0) {
@@ -97,11 +139,12 @@ gc_alloc::response gc_pool_allocator::freelist_allocation(size_t size, const gc_
     byte* ptr  = reinterpret_cast<byte*>(m_freelist);
     m_freelist = reinterpret_cast<byte**>(m_freelist[0]);
 
-    assert(contains(ptr));
-
     gc_new_stack_entry* stack_entry = reinterpret_cast<gc_new_stack_entry*>(rqst.buffer());
     memset(ptr, 0, size);
     descriptor_t* descr = static_cast<descriptor_t*>(memory_index::get_descriptor(ptr).to_gc_descriptor());
+    // freelist allocation is frequent in the sticky mark bits mode, so the chunk is checked instead of contains(ptr)
+    assert(descr && descr->contains(ptr));
+    descr->set_fresh(true);
     return init_cell(ptr, rqst, descr);
 }
 
@@ -119,9 +162,9 @@ gc_alloc::response gc_pool_allocator::init_cell(byte* cell_start, const gc_alloc
 
 gc_pool_allocator::iterator_t gc_pool_allocator::create_descriptor(byte* blk, size_t blk_size, size_t cell_size)
 {
-    m_descrs.emplace_back(blk, blk_size, cell_size);
+    m_descrs.emplace_back(blk, blk_size, cell_size, m_numa_node, m_young);
     auto last = std::prev(m_descrs.end());
-    memory_index::index_gc_heap_memory(blk, blk_size, &(*last));
+    memory_index::index_gc_pool_memory(blk, blk_size, &(*last), log2(cell_size));
     return last;
 }
 
@@ -137,13 +180,43 @@ std::pair<byte*, size_t> gc_pool_allocator::allocate_block(size_t cell_size)
 {
     assert(m_core_alloc);
     size_t chunk_size = descriptor_t::chunk_size(cell_size);
-    return std::make_pair(m_core_alloc->allocate(chunk_size), chunk_size);
+    if (m_chunk_cache) {
+        // cached chunk is still counted in the heap size
+        byte* chunk   = reinterpret_cast<byte*>(m_chunk_cache);
+        m_chunk_cache = reinterpret_cast<byte**>(m_chunk_cache[0]);
+        --m_chunk_cache_size;
+        memset(chunk, 0, chunk_size);
+        return std::make_pair(chunk, chunk_size);
+    }
+    return std::make_pair(m_core_alloc->allocate(chunk_size, m_numa_node), chunk_size);
 }
 
 void gc_pool_allocator::deallocate_block(byte* ptr, size_t size)
 {
     assert(m_core_alloc);
-    m_core_alloc->deallocate(ptr, size);
+    // all chunks of the allocator have the same size,
+    // so cached chunk can be reused without going through the core allocator;
+    // it is kept in the heap size until it is flushed, thus the heap limit covers the cache too
+    if (m_chunk_cache_size < CHUNK_CACHE_SIZE) {
+        byte** next   = reinterpret_cast<byte**>(ptr);
+        next[0]       = reinterpret_cast<byte*>(m_chunk_cache);
+        next[1]       = reinterpret_cast<byte*>(size);
+        m_chunk_cache = next;
+        ++m_chunk_cache_size;
+        return;
+    }
+    m_core_alloc->deallocate(ptr, size, m_numa_node);
+}
+
+void gc_pool_allocator::flush_chunk_cache()
+{
+    while (m_chunk_cache) {
+        byte*  chunk  = reinterpret_cast<byte*>(m_chunk_cache);
+        size_t size   = reinterpret_cast<size_t>(m_chunk_cache[1]);
+        m_chunk_cache = reinterpret_cast<byte**>(m_chunk_cache[0]);
+        m_core_alloc->deallocate(chunk, size, m_numa_node);
+    }
+    m_chunk_cache_size = 0;
 }
 
 bool gc_pool_allocator::contains(byte* ptr) const
@@ -158,6 +231,9 @@ bool gc_pool_allocator::contains(byte* ptr) const
 
 gc_collect_stat gc_pool_allocator::collect(compacting::forwarding& frwd)
 {
+    // chunks which have not been reused since the previous collection are returned to the core allocator
+    flush_chunk_cache();
+
     if (m_descrs.begin() == m_descrs.end()) {
         return gc_collect_stat();
     }
@@ -206,6 +282,7 @@ void gc_pool_allocator::sweep(gc_collect_stat& stat)
 {
     for (auto& descr: m_descrs) {
         stat.mem_freed += sweep(descr, true);
+        descr.set_fresh(false);
     }
 }
 
@@ -298,6 +375,208 @@ void gc_pool_allocator::compact(compacting::forwarding& frwd, gc_collect_stat& s
     }
 }
 
+gc_cell gc_pool_allocator::allocate_promoted(size_t size)
+{
+    if (m_freelist) {
+        byte* ptr  = reinterpret_cast<byte*>(m_freelist);
+        m_freelist = reinterpret_cast<byte**>(m_freelist[0]);
+        memset(ptr, 0, size);
+        return gc_cell::from_cell_start(ptr, memory_index::get_descriptor(ptr).to_gc_descriptor());
+    }
+    if (m_top == m_end) {
+        byte*  blk;
+        size_t blk_size;
+        std::tie(blk, blk_size) = allocate_block(size);
+        if (!blk) {
+            // collection is already in progress, so the heap can only be expanded
+            m_core_alloc->expand_heap();
+            std::tie(blk, blk_size) = allocate_block(size);
+        }
+        if (!blk) {
+            return gc_cell();
+        }
+        create_descriptor(blk, blk_size, size);
+        m_top = blk;
+        m_end = blk + blk_size;
+    }
+    byte* ptr = m_top;
+    m_top += size;
+    return gc_cell::from_cell_start(ptr, &m_descrs.back());
+}
+
+gc_collect_stat gc_pool_allocator::evacuate(gc_pool_allocator& old_gen, compacting::forwarding& frwd)
+{
+    assert(m_young && !old_gen.m_young);
+
+    gc_collect_stat stat;
+    bool old_gen_full = false;
+    for (auto& descr: m_descrs) {
+        if (descr.unused()) {
+            continue;
+        }
+        size_t cell_size = descr.cell_size();
+        for (gc_cell from: descr.memory_range()) {
+            if (from.get_lifetime_tag() != gc_lifetime_tag::LIVE) {
+                continue;
+            }
+            gc_cell to;
+            if (!from.get_pin() && !old_gen_full) {
+                to = old_gen.allocate_promoted(cell_size);
+                old_gen_full = !to.get();
+            }
+            if (!to.get()) {
+                m_survivors.push_back(from);
+                continue;
+            }
+
+            from.move(to);
+            #ifdef WITH_DESTRUCTORS
+                from.finalize();
+            #endif
+            frwd.create(from.get(), to.get());
+            old_gen.m_survivors.push_back(to);
+
+            stat.mem_moved += cell_size;
+        }
+    }
+    return stat;
+}
+
+void gc_pool_allocator::fix_survivors(const compacting::forwarding& frwd, std::vector<gc_handle*>& young_slots)
+{
+    if (m_young) {
+        for (gc_cell& cell: m_survivors) {
+            cell.trace([&frwd] (gc_handle* handle) {
+                frwd.forward(handle);
+            });
+        }
+        m_survivors.clear();
+        return;
+    }
+    for (gc_cell& cell: m_survivors) {
+        cell.trace([&frwd, &young_slots] (gc_handle* handle) {
+            frwd.forward(handle);
+            if (gc_pool_descriptor::is_young_ptr(gc_handle_access::get<std::memory_order_relaxed>(*handle))) {
+                young_slots.push_back(handle);
+            }
+        });
+        // old generation is not marked by minor collections
+        cell.set_mark(false);
+    }
+    m_survivors.clear();
+}
+
+gc_collect_stat gc_pool_allocator::release_evacuated()
+{
+    assert(m_young);
+
+    gc_collect_stat stat;
+
+    flush_chunk_cache();
+
+    m_top = nullptr;
+    m_end = nullptr;
+    m_freelist = nullptr;
+
+    for (iterator_t it = m_descrs.begin(), end = m_descrs.end(); it != end; ) {
+        stat.mem_used += it->size();
+        if (it->unused()) {
+            stat.mem_freed += it->size();
+            it = destroy_descriptor(it);
+        } else {
+            stat.pinned_cnt += it->count_pinned();
+            stat.mem_freed += sweep(*it, true);
+            it->unmark();
+            ++it;
+        }
+    }
+    return stat;
+}
+
+gc_collect_stat gc_pool_allocator::sweep_fresh()
+{
+    gc_collect_stat stat;
+    flush_chunk_cache();
+    for (auto& descr: m_descrs) {
+        stat.mem_used += descr.size();
+        stat.pinned_cnt += descr.count_pinned();
+        descr.unpin();
+        if (!descr.is_fresh()) {
+            continue;
+        }
+        descr.set_fresh(false);
+        // free cells which are not initialized are already in the freelist or above the top of the current chunk
+        size_t cell_size = descr.cell_size();
+        byte*  it = descr.memory();
+        for (size_t i = 0; it < descr.memory() + descr.size(); it += cell_size, ++i) {
+            if (!descr.get_mark(i) && descr.is_init(i)) {
+                free_cell(descr, i, it);
+                stat.mem_freed += cell_size;
+            }
+        }
+    }
+    // bump allocation continues in the current chunk
+    if (m_top != m_end) {
+        m_descrs.back().set_fresh(true);
+    }
+    return stat;
+}
+
+gc_collect_stat gc_pool_allocator::sweep_local()
+{
+    gc_collect_stat stat;
+    flush_chunk_cache();
+    for (auto& descr: m_descrs) {
+        stat.mem_used += descr.size();
+        stat.pinned_cnt += descr.count_pinned();
+        descr.unpin();
+        if (!descr.is_fresh()) {
+            continue;
+        }
+        bool has_local = false;
+        size_t cell_size = descr.cell_size();
+        byte*  it = descr.memory();
+        for (size_t i = 0; it < descr.memory() + descr.size(); it += cell_size, ++i) {
+            if (descr.is_shared(i)) {
+                continue;
+            }
+            if (descr.get_mark(i)) {
+                descr.set_mark(i, false);
+                has_local = true;
+            } else if (descr.is_init(i)) {
+                free_cell(descr, i, it);
+                stat.mem_freed += cell_size;
+            }
+        }
+        // chunk is swept by the next local collection only if it still has local survivors
+        descr.set_fresh(has_local);
+    }
+    if (m_top != m_end) {
+        m_descrs.back().set_fresh(true);
+    }
+    return stat;
+}
+
+void gc_pool_allocator::free_cell(descriptor_t& descr, size_t idx, byte* cell)
+{
+    #ifdef WITH_DESTRUCTORS
+        descr.finalize(idx);
+    #else
+        descr.set_init(idx, false);
+    #endif
+    // the cell is known to belong to the chunk, insert_into_freelist would look it up among all chunks
+    byte** next = reinterpret_cast<byte**>(cell);
+    next[0]     = reinterpret_cast<byte*>(m_freelist);
+    m_freelist  = next;
+}
+
+void gc_pool_allocator::unpin()
+{
+    for (auto& descr: m_descrs) {
+        descr.unpin();
+    }
+}
+
 void gc_pool_allocator::fix(const compacting::forwarding& frwd)
 {
     auto rng = memory_range();
@@ -311,6 +590,15 @@ void gc_pool_allocator::finalize()
     }
 }
 
+void gc_pool_allocator::trace_live(const gc_cell_callback& cb)
+{
+    for (auto cell: memory_range()) {
+        if (cell.get_lifetime_tag() == gc_lifetime_tag::LIVE) {
+            cb(cell);
+        }
+    }
+}
+
 gc_memstat gc_pool_allocator::stats()
 {
     gc_memstat stat;
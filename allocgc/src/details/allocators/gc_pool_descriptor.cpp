@@ -1,18 +1,34 @@
 #include <liballocgc/details/allocators/gc_pool_descriptor.hpp>
 
 #include <liballocgc/details/allocators/gc_box.hpp>
+#include <liballocgc/details/allocators/memory_index.hpp>
 
 namespace allocgc { namespace details { namespace allocators {
 
-gc_pool_descriptor::gc_pool_descriptor(byte* chunk, size_t size, size_t cell_size)
-    : m_memory(chunk)
+gc_pool_descriptor::gc_pool_descriptor(byte* chunk, size_t size, size_t cell_size, size_t numa_node, bool young)
+    : gc_memory_descriptor(gc_descriptor_kind::POOL)
+    , m_memory(chunk)
     , m_size(size)
     , m_cell_size_log2(log2(cell_size))
-{}
+    , m_numa_node(numa_node)
+    , m_young(young)
+    , m_fresh(false)
+    , m_heap_marks(memory_index::heap_mark_bitmap().contains(chunk) ? &memory_index::heap_mark_bitmap() : nullptr)
+{
+    // memory of the chunk could be used by another chunk before, so its bits in the heap bitmap should be cleared
+    if (m_heap_marks) {
+        m_heap_marks->reset(m_memory, m_size);
+    }
+}
 
 gc_pool_descriptor::~gc_pool_descriptor()
 {}
 
+bool gc_pool_descriptor::is_young_ptr(byte* ptr)
+{
+    return ptr && is_young_cell(memory_index::get_gc_cell(ptr));
+}
+
 bool gc_pool_descriptor::contains(byte* ptr) const
 {
     byte* mem_begin = memory();
@@ -22,7 +38,7 @@ bool gc_pool_descriptor::contains(byte* ptr) const
 
 double gc_pool_descriptor::residency() const
 {
-    return static_cast<double>(m_mark_bits.count()) / m_mark_bits.size();
+    return static_cast<double>(count_lived()) / m_mark_bits.size();
 }
 
 gc_pool_descriptor::memory_range_type gc_pool_descriptor::memory_range()
@@ -56,10 +72,29 @@ void gc_pool_descriptor::set_init(byte* ptr, bool init)
     set_init(idx, init);
 }
 
+bool gc_pool_descriptor::is_shared(byte* ptr) const
+{
+    assert(contains(ptr));
+    assert(ptr == cell_start(ptr));
+    size_t idx = calc_cell_ind(ptr);
+    return is_shared(idx);
+}
+
+void gc_pool_descriptor::set_shared(byte* ptr, bool shared)
+{
+    assert(contains(ptr));
+    assert(ptr == cell_start(ptr));
+    size_t idx = calc_cell_ind(ptr);
+    set_shared(idx, shared);
+}
+
 bool gc_pool_descriptor::get_mark(byte* ptr) const
 {
     assert(contains(ptr));
     assert(ptr == cell_start(ptr));
+    if (m_heap_marks) {
+        return m_heap_marks->get(ptr);
+    }
     size_t idx = calc_cell_ind(ptr);
     return get_mark(idx);
 }
@@ -76,10 +111,25 @@ void gc_pool_descriptor::set_mark(byte* ptr, bool mark)
 {
     assert(contains(ptr));
     assert(ptr == cell_start(ptr));
+    if (m_heap_marks) {
+        m_heap_marks->set(ptr, mark);
+        return;
+    }
     size_t idx = calc_cell_ind(ptr);
     set_mark(idx, mark);
 }
 
+bool gc_pool_descriptor::try_mark(byte* ptr)
+{
+    assert(contains(ptr));
+    assert(ptr == cell_start(ptr));
+    if (m_heap_marks) {
+        return !m_heap_marks->test_and_set(ptr);
+    }
+    size_t idx = calc_cell_ind(ptr);
+    return try_mark(idx);
+}
+
 void gc_pool_descriptor::set_pin(byte* ptr, bool pin)
 {
     assert(contains(ptr));
@@ -166,6 +216,7 @@ void gc_pool_descriptor::move(byte* to, byte* from, gc_memory_descriptor* from_d
     size_t idx = calc_cell_ind(to);
     set_mark(idx, true);
     set_init(idx, true);
+    set_shared(idx, is_shared_cell(gc_cell::from_cell_start(from, from_descr)));
 }
 
 void gc_pool_descriptor::finalize(size_t i)
@@ -202,4 +253,9 @@ size_t gc_pool_descriptor::mem_used()
     return used;
 }
 
+size_t gc_pool_descriptor::numa_node() const
+{
+    return m_numa_node;
+}
+
 }}}
@@ -8,11 +8,14 @@ namespace allocgc { namespace details { namespace allocators {
 
 size_t gc_so_allocator::SZ_CLS[] = {32, 64, 128, 256, 512, 1024, 2048, 4096};
 
-gc_so_allocator::gc_so_allocator(gc_core_allocator* core_alloc)
+gc_so_allocator::gc_so_allocator(gc_core_allocator* core_alloc, size_t numa_node, gc_nursery* nursery, bool young)
 {
     size_t j = 0;
     for (size_t i = 0; i < BUCKET_COUNT; ++i) {
         m_buckets[i].set_core_allocator(core_alloc);
+        m_buckets[i].set_numa_node(numa_node);
+        m_buckets[i].set_nursery(nursery);
+        m_buckets[i].set_young(young);
 
         size_t sz_cls = SZ_CLS[i];
         while (j < sz_cls) {
@@ -72,6 +75,119 @@ void gc_so_allocator::finalize()
     }
 }
 
+gc_collect_stat gc_so_allocator::evacuate(gc_so_allocator& old_gen, compacting::forwarding& frwd,
+                                          thread_pool_t& thread_pool)
+{
+    std::vector<std::function<void()>> tasks;
+    std::array<gc_collect_stat, BUCKET_COUNT> part_stats;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        if (m_buckets[i].empty()) {
+            continue;
+        }
+        tasks.emplace_back([this, i, &old_gen, &frwd, &part_stats] {
+            part_stats[i] = m_buckets[i].evacuate(old_gen.m_buckets[i], frwd);
+        });
+    }
+    thread_pool.run(tasks.begin(), tasks.end());
+
+    gc_collect_stat stat;
+    for (auto& part_stat: part_stats) {
+        stat += part_stat;
+    }
+
+    return stat;
+}
+
+void gc_so_allocator::fix_survivors(const compacting::forwarding& frwd, thread_pool_t& thread_pool,
+                                    std::vector<gc_handle*>& young_slots)
+{
+    std::vector<std::function<void()>> tasks;
+    std::array<std::vector<gc_handle*>, BUCKET_COUNT> part_slots;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        if (m_buckets[i].empty()) {
+            continue;
+        }
+        tasks.emplace_back([this, i, &frwd, &part_slots] {
+            m_buckets[i].fix_survivors(frwd, part_slots[i]);
+        });
+    }
+    thread_pool.run(tasks.begin(), tasks.end());
+
+    for (auto& slots: part_slots) {
+        young_slots.insert(young_slots.end(), slots.begin(), slots.end());
+    }
+}
+
+gc_collect_stat gc_so_allocator::release_evacuated()
+{
+    gc_collect_stat stat;
+    for (auto& bucket: m_buckets) {
+        stat += bucket.release_evacuated();
+    }
+    return stat;
+}
+
+gc_collect_stat gc_so_allocator::sweep_fresh(thread_pool_t& thread_pool)
+{
+    std::vector<std::function<void()>> tasks;
+    std::array<gc_collect_stat, BUCKET_COUNT> part_stats;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        if (m_buckets[i].empty()) {
+            continue;
+        }
+        tasks.emplace_back([this, i, &part_stats] {
+            part_stats[i] = m_buckets[i].sweep_fresh();
+        });
+    }
+    thread_pool.run(tasks.begin(), tasks.end());
+
+    gc_collect_stat stat;
+    for (auto& part_stat: part_stats) {
+        stat += part_stat;
+    }
+    return stat;
+}
+
+gc_collect_stat gc_so_allocator::sweep_local(thread_pool_t& thread_pool)
+{
+    std::vector<std::function<void()>> tasks;
+    std::array<gc_collect_stat, BUCKET_COUNT> part_stats;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        if (m_buckets[i].empty()) {
+            continue;
+        }
+        tasks.emplace_back([this, i, &part_stats] {
+            part_stats[i] = m_buckets[i].sweep_local();
+        });
+    }
+    thread_pool.run(tasks.begin(), tasks.end());
+
+    gc_collect_stat stat;
+    for (auto& part_stat: part_stats) {
+        stat += part_stat;
+    }
+    return stat;
+}
+
+void gc_so_allocator::unpin()
+{
+    for (auto& bucket: m_buckets) {
+        bucket.unpin();
+    }
+}
+
+gc_nursery* gc_so_allocator::nursery() const
+{
+    return m_buckets.front().get_nursery();
+}
+
+void gc_so_allocator::trace_live(const gc_cell_callback& cb)
+{
+    for (auto& bucket: m_buckets) {
+        bucket.trace_live(cb);
+    }
+}
+
 gc_memstat gc_so_allocator::stats()
 {
     gc_memstat stat;
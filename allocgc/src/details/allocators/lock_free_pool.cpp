@@ -0,0 +1,116 @@
+#include <liballocgc/details/allocators/lock_free_pool.hpp>
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/mman.h>
+
+#include <liballocgc/details/allocators/sys_allocator.hpp>
+#include <liballocgc/details/constants.hpp>
+#include <liballocgc/details/logging.hpp>
+
+namespace allocgc { namespace details { namespace allocators {
+
+const size_t lock_free_pool::DEFAULT_RESERVE_SIZE = (size_t) 1024 * 1024 * 1024;
+
+namespace {
+const size_t OBJ_ALIGN = 64;
+const std::uintptr_t PTR_MASK = ((std::uintptr_t) 1 << POINTER_BITS_USED) - 1;
+}
+
+lock_free_pool::lock_free_pool(size_t obj_size, size_t reserve_size)
+    : m_obj_size(((obj_size + OBJ_ALIGN - 1) / OBJ_ALIGN) * OBJ_ALIGN)
+    , m_base(nullptr)
+    , m_size(0)
+    , m_top(0)
+    , m_free(0)
+    , m_retired(nullptr)
+{
+    assert(m_free.is_lock_free());
+
+    reserve_size = sys_allocator::align_size(reserve_size);
+    void* mem = mmap(nullptr, reserve_size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mem == MAP_FAILED) {
+        logging::warning() << "pool reservation failed: " << strerror(errno);
+        return;
+    }
+    m_base = reinterpret_cast<byte*>(mem);
+    m_size = reserve_size;
+}
+
+byte* lock_free_pool::allocate()
+{
+    byte* ptr = pop_free();
+    if (ptr) {
+        return ptr;
+    }
+
+    size_t top = m_top.load(std::memory_order_relaxed);
+    do {
+        if (top + m_obj_size > m_size) {
+            // reserved region is exhausted
+            return sys_allocator::allocate(sys_allocator::align_size(m_obj_size));
+        }
+    } while (!m_top.compare_exchange_weak(top, top + m_obj_size, std::memory_order_relaxed));
+
+    return m_base + top;
+}
+
+void lock_free_pool::retire(byte* ptr)
+{
+    assert(ptr);
+    byte* head = m_retired.load(std::memory_order_relaxed);
+    do {
+        next(ptr) = head;
+    } while (!m_retired.compare_exchange_weak(head, ptr, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void lock_free_pool::reclaim()
+{
+    byte* first = m_retired.exchange(nullptr, std::memory_order_acquire);
+    if (!first) {
+        return;
+    }
+    byte* last = first;
+    while (next(last)) {
+        last = next(last);
+    }
+
+    tagged_ptr_t head = m_free.load(std::memory_order_relaxed);
+    do {
+        next(last) = get_ptr(head);
+    } while (!m_free.compare_exchange_weak(head, make_tagged(first, head),
+                                           std::memory_order_release, std::memory_order_relaxed));
+}
+
+byte* lock_free_pool::pop_free()
+{
+    tagged_ptr_t head = m_free.load(std::memory_order_acquire);
+    byte* ptr;
+    do {
+        ptr = get_ptr(head);
+        if (!ptr) {
+            return nullptr;
+        }
+        // memory of the pool is never unmapped, so reading the next pointer of the popped by other thread object is safe,
+        // and the counter prevents ABA
+    } while (!m_free.compare_exchange_weak(head, make_tagged(next(ptr), head),
+                                           std::memory_order_acquire, std::memory_order_acquire));
+    return ptr;
+}
+
+byte* lock_free_pool::get_ptr(tagged_ptr_t head)
+{
+    return reinterpret_cast<byte*>(head & PTR_MASK);
+}
+
+lock_free_pool::tagged_ptr_t lock_free_pool::make_tagged(byte* ptr, tagged_ptr_t prev_head)
+{
+    assert((reinterpret_cast<std::uintptr_t>(ptr) & ~PTR_MASK) == 0);
+    tagged_ptr_t tag = (prev_head >> POINTER_BITS_USED) + 1;
+    return reinterpret_cast<std::uintptr_t>(ptr) | (tag << POINTER_BITS_USED);
+}
+
+}}}
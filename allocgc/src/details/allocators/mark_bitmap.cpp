@@ -0,0 +1,57 @@
+#include <liballocgc/details/allocators/mark_bitmap.hpp>
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#include <sys/mman.h>
+
+#include <liballocgc/details/logging.hpp>
+
+namespace allocgc { namespace details { namespace allocators {
+
+void mark_bitmap::init(const byte* base, size_t size)
+{
+    assert(!m_bits);
+    assert(reinterpret_cast<std::uintptr_t>(base) % PAGE_SIZE == 0);
+    assert(size % (WORD_BITS * MIN_CELL_SIZE) == 0);
+    assert(word_t().is_lock_free());
+
+    size_t bitmap_size = (size >> MIN_CELL_SIZE_LOG2) / CHAR_BIT;
+    void* bits = mmap(nullptr, bitmap_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (bits == MAP_FAILED) {
+        logging::warning() << "mark bitmap mmap failed: " << strerror(errno);
+        return;
+    }
+
+    m_bits = reinterpret_cast<word_t*>(bits);
+    m_base = reinterpret_cast<std::uintptr_t>(base);
+    m_size = size;
+}
+
+void mark_bitmap::reset(const byte* mem, size_t size)
+{
+    assert(contains(mem) && contains(mem + size - 1));
+    assert(bit_idx(mem) % WORD_BITS == 0);
+    size_t first = word_idx(bit_idx(mem));
+    size_t last  = word_idx(bit_idx(mem + size - 1));
+    for (size_t i = first; i <= last; ++i) {
+        m_bits[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t mark_bitmap::count(const byte* mem, size_t size) const
+{
+    assert(contains(mem) && contains(mem + size - 1));
+    assert(bit_idx(mem) % WORD_BITS == 0);
+    size_t first = word_idx(bit_idx(mem));
+    size_t last  = word_idx(bit_idx(mem + size - 1));
+    size_t cnt = 0;
+    for (size_t i = first; i <= last; ++i) {
+        cnt += __builtin_popcountll(m_bits[i].load(std::memory_order_relaxed));
+    }
+    return cnt;
+}
+
+}}}
@@ -0,0 +1,33 @@
+#include <liballocgc/details/allocators/page_table.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/mman.h>
+
+#include <liballocgc/details/logging.hpp>
+
+namespace allocgc { namespace details { namespace allocators {
+
+void page_table::init(const byte* base, size_t size)
+{
+    assert(!m_table);
+    assert(reinterpret_cast<std::uintptr_t>(base) % PAGE_SIZE == 0);
+    assert(size % PAGE_SIZE == 0);
+    assert(std::atomic<memory_descriptor>().is_lock_free());
+
+    size_t table_size = (size >> PAGE_SIZE_LOG2) * sizeof(entry_t);
+    void* table = mmap(nullptr, table_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (table == MAP_FAILED) {
+        logging::warning() << "page table mmap failed: " << strerror(errno);
+        return;
+    }
+
+    // zeroed memory is a table of null descriptors
+    m_table = reinterpret_cast<entry_t*>(table);
+    m_base  = reinterpret_cast<std::uintptr_t>(base);
+    m_size  = size;
+}
+
+}}}
@@ -0,0 +1,210 @@
+#include <liballocgc/details/allocators/reserved_range_allocator.hpp>
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+
+#include <sys/mman.h>
+
+#include <liballocgc/details/allocators/sys_allocator.hpp>
+#include <liballocgc/details/allocators/memory_index.hpp>
+#include <liballocgc/details/constants.hpp>
+#include <liballocgc/details/logging.hpp>
+
+namespace allocgc { namespace details { namespace allocators {
+
+const size_t reserved_range_allocator::DEFAULT_RESERVE_SIZE = (size_t) 32 * 1024 * 1024 * 1024;
+
+namespace {
+
+const char* RESERVE_SIZE_ENV = "ALLOCGC_HEAP_RESERVE";
+
+class reservation : private utils::noncopyable, private utils::nonmovable
+{
+public:
+    static reservation& instance()
+    {
+        static reservation r;
+        return r;
+    }
+
+    byte* allocate(size_t size)
+    {
+        assert(size % PAGE_SIZE == 0);
+
+        // freed ranges are reused before the untouched part of the reservation, the counter spares the lock
+        // while nothing suitable has been freed
+        if (m_free_max.load(std::memory_order_relaxed) >= size) {
+            if (byte* ptr = allocate_from_freelist(size)) {
+                return ptr;
+            }
+        }
+
+        size_t top = m_top.load(std::memory_order_relaxed);
+        do {
+            if (top + size > m_size) {
+                return nullptr;
+            }
+        } while (!m_top.compare_exchange_weak(top, top + size, std::memory_order_relaxed));
+
+        byte* ptr = m_base + top;
+        // reserved memory is inaccessible until it is handed out
+        if (mprotect(ptr, size, PROT_READ | PROT_WRITE) != 0) {
+            logging::error() << "mprotect failed: " << strerror(errno);
+            return nullptr;
+        }
+        return ptr;
+    }
+
+    void deallocate(byte* ptr, size_t size)
+    {
+        assert(contains(ptr));
+        assert(size % PAGE_SIZE == 0);
+
+        // give physical memory back to the OS, but keep the address range
+        madvise(ptr, size, MADV_DONTNEED);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // coalesce with the free neighbours
+        auto next = m_free.lower_bound(ptr);
+        if (next != m_free.end() && ptr + size == next->first) {
+            size += next->second;
+            next = erase_free(next);
+        }
+        if (next != m_free.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == ptr) {
+                ptr   = prev->first;
+                size += prev->second;
+                next  = erase_free(prev);
+            }
+        }
+        // range adjacent to the top is returned to the untouched part, unless the top has moved concurrently
+        size_t top = ptr - m_base + size;
+        if (m_top.compare_exchange_strong(top, ptr - m_base, std::memory_order_relaxed)) {
+            update_free_max();
+            return;
+        }
+        m_free.emplace_hint(next, ptr, size);
+        m_free_by_size.emplace(size, ptr);
+        update_free_max();
+    }
+
+    bool contains(const byte* ptr) const
+    {
+        return m_base <= ptr && ptr < m_base + m_size;
+    }
+
+    reserved_range_allocator::memory_range_type range() const
+    {
+        return reserved_range_allocator::memory_range_type(m_base, m_base + m_size);
+    }
+private:
+    typedef std::map<byte*, size_t> free_map_t;
+
+    reservation()
+        : m_base(nullptr)
+        , m_size(0)
+        , m_top(0)
+        , m_free_max(0)
+    {
+        size_t size = reserved_range_allocator::DEFAULT_RESERVE_SIZE;
+        if (const char* env = std::getenv(RESERVE_SIZE_ENV)) {
+            size = sys_allocator::align_size(std::strtoull(env, nullptr, 10));
+        }
+        if (size == 0) {
+            return;
+        }
+
+        void* mem = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (mem == MAP_FAILED) {
+            logging::warning() << "heap reservation failed: " << strerror(errno);
+            return;
+        }
+
+        m_base = reinterpret_cast<byte*>(mem);
+        m_size = size;
+
+        // page table should be ready before any memory of the range is indexed
+        memory_index::init_page_table(m_base, m_size);
+    }
+
+    // best fit, ties are broken in favour of the lowest address
+    byte* allocate_from_freelist(size_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto fit = m_free_by_size.lower_bound(std::make_pair(size, (byte*) nullptr));
+        if (fit == m_free_by_size.end()) {
+            return nullptr;
+        }
+        byte*  ptr  = fit->second;
+        size_t rest = fit->first - size;
+        erase_free(m_free.find(ptr));
+        if (rest > 0) {
+            m_free.emplace(ptr + size, rest);
+            m_free_by_size.emplace(rest, ptr + size);
+        }
+        update_free_max();
+        return ptr;
+    }
+
+    free_map_t::iterator erase_free(free_map_t::iterator it)
+    {
+        m_free_by_size.erase(std::make_pair(it->second, it->first));
+        return m_free.erase(it);
+    }
+
+    void update_free_max()
+    {
+        size_t max = m_free_by_size.empty() ? 0 : m_free_by_size.rbegin()->first;
+        m_free_max.store(max, std::memory_order_relaxed);
+    }
+
+    byte* m_base;
+    size_t m_size;
+    std::atomic<size_t> m_top;
+    // free ranges are indexed both by the address, for the coalescing, and by the size, for the best fit
+    free_map_t m_free;
+    std::set<std::pair<size_t, byte*>> m_free_by_size;
+    std::atomic<size_t> m_free_max;
+    std::mutex m_mutex;
+};
+
+}
+
+byte* reserved_range_allocator::allocate(size_t size)
+{
+    byte* ptr = reservation::instance().allocate(size);
+    if (!ptr) {
+        ptr = sys_allocator::allocate(size);
+    }
+    return ptr;
+}
+
+void reserved_range_allocator::deallocate(byte* ptr, size_t size)
+{
+    reservation& r = reservation::instance();
+    if (r.contains(ptr)) {
+        r.deallocate(ptr, size);
+    } else {
+        sys_allocator::deallocate(ptr, size);
+    }
+}
+
+bool reserved_range_allocator::contains(const byte* ptr)
+{
+    return reservation::instance().contains(ptr);
+}
+
+reserved_range_allocator::memory_range_type reserved_range_allocator::reserved_range()
+{
+    return reservation::instance().range();
+}
+
+}}}
@@ -9,9 +9,14 @@
 
 namespace allocgc { namespace details { namespace collectors {
 
+const gc_clock::duration gc_cms::PRECLEAN_TIME_LIMIT = std::chrono::milliseconds(20);
+
 gc_cms::gc_cms()
     : gc_core(&m_remset)
+    , m_marking(false)
     , m_phase(gc_phase::IDLE)
+    , m_incremental(false)
+    , m_marker_threads(threads_available())
 {}
 
 gc_alloc::response gc_cms::allocate(const gc_alloc::request& rqst)
@@ -41,16 +46,26 @@ void gc_cms::commit(const gc_alloc::response& rsp, const gc_type_meta* type_meta
     }
 }
 
-void gc_cms::wbarrier(gc_handle& dst, const gc_handle& src)
+void gc_cms::wbarrier_marking(gc_handle& dst, const gc_handle& src)
 {
-    gc_unsafe_scope unsafe_scope;
     byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(src);
     gc_handle_access::set<std::memory_order_release>(dst, ptr);
-    if (m_phase == gc_phase::MARK && ptr) {
-        gc_cell cell = allocators::memory_index::get_gc_cell(ptr);
-        if (!cell.get_mark()) {
-            m_remset.add(ptr);
-        }
+    // the card is dirtied in the same unsafe scope as the store, so the final pause can not find it clean,
+    // and after the store, since the concurrent precleaning cleans the card before scanning it
+    bool carded = allocators::memory_index::heap_card_table().dirty(reinterpret_cast<const byte*>(&dst));
+    if (!carded) {
+        remember(ptr);
+    }
+}
+
+void gc_cms::remember(byte* ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    gc_cell cell = allocators::memory_index::get_gc_cell(ptr);
+    if (!cell.get_mark()) {
+        m_remset.add(ptr);
     }
 }
 
@@ -67,16 +82,44 @@ gc_runstat gc_cms::gc_impl(const gc_options& options)
     return gc_runstat();
 }
 
+void gc_cms::mark_increment_impl(size_t alloc_size)
+{
+    if (m_phase != gc_phase::MARK) {
+        return;
+    }
+    if (!m_incremental) {
+        // marking is done by the marker threads, just check whether they have finished
+        if (get_marker().concurrent_done()) {
+            m_pacer.concurrent_done(get_heap().size());
+        }
+        return;
+    }
+    gc_clock::time_point start = gc_clock::now();
+    bool has_work = mark_slice(MARK_INCREMENT_RATIO * alloc_size);
+    if (!has_work) {
+        m_pacer.concurrent_done(get_heap().size());
+    }
+    logging::debug() << "Incremental mark slice " << duration_to_str(gc_clock::now() - start)
+                     << (has_work ? "" : " (no more work)");
+}
+
 gc_runstat gc_cms::start_marking_phase()
 {
     using namespace threads;
     assert(m_phase == gc_phase::IDLE);
 
     auto snapshot = stop_the_world();
+    start_barrier();
     trace_uninit(snapshot);
     trace_roots(snapshot);
     m_phase = gc_phase::MARK;
-    start_concurrent_marking(std::max((size_t) 1, threads_available() - 1));
+    update_marking_flag();
+    m_incremental = threads_available() <= 1;
+    // threads available could be changed since the last pacing
+    size_t threads_max = threads_available() > 1 ? threads_available() - 1 : 1;
+    size_t marker_threads = m_incremental ? 0 : std::max((size_t) 1, std::min(m_marker_threads, threads_max));
+    m_pacer.start_cycle(get_heap().size(), get_marker().marked_mem(), marker_threads);
+    start_concurrent_marking(marker_threads);
 
     gc_runstat stats;
     stats.pause = snapshot.time_since_stop_the_world();
@@ -88,6 +131,10 @@ gc_runstat gc_cms::sweep()
     using namespace threads;
     assert(m_phase == gc_phase::IDLE || m_phase == gc_phase::MARK);
 
+    if (m_phase == gc_phase::MARK) {
+        preclean();
+    }
+
     world_snapshot snapshot = stop_the_world();
     if (m_phase == gc_phase::IDLE) {
         trace_uninit(snapshot);
@@ -98,12 +145,14 @@ gc_runstat gc_cms::sweep()
         start_concurrent_marking(threads_available() - 1);
         start_marking();
     } else if (m_phase == gc_phase::MARK) {
-        trace_uninit(snapshot);
-        trace_pins(snapshot);
-        trace_remset();
-        start_marking();
+        size_t heap_size = get_heap().size();
+        size_t concurrent_marked_mem = get_marker().marked_mem();
+        remark(snapshot);
+        start_marking(threads_available() - 1);
+        m_pacer.finish_cycle(heap_size, get_heap().limit(), concurrent_marked_mem, get_marker().marked_mem());
     }
     m_phase = gc_phase::COLLECT;
+    update_marking_flag();
 
     gc_runstat stats;
 
@@ -111,10 +160,62 @@ gc_runstat gc_cms::sweep()
     stats.pause = snapshot.time_since_stop_the_world();
 
     m_phase = gc_phase::IDLE;
+    pace();
 
     return stats;
 }
 
+void gc_cms::start_barrier()
+{
+    // cards dirtied before the marking are of no interest, since all the heap is going to be traced
+    allocators::memory_index::heap_card_table().clear();
+}
+
+void gc_cms::preclean_barrier()
+{
+    trace_cards();
+}
+
+void gc_cms::remark(const threads::world_snapshot& snapshot)
+{
+    trace_uninit(snapshot);
+    trace_pins(snapshot);
+    trace_remset();
+    trace_cards();
+}
+
+void gc_cms::update_marking_flag()
+{
+    m_marking.store(m_phase == gc_phase::MARK, std::memory_order_relaxed);
+}
+
+void gc_cms::preclean()
+{
+    gc_clock::time_point start = gc_clock::now();
+    size_t rounds = 0;
+    while (gc_clock::now() - start < PRECLEAN_TIME_LIMIT) {
+        ++rounds;
+        preclean_barrier();
+        bool has_work = mark_slice(PRECLEAN_BUDGET);
+        if (!has_work && m_remset.size() <= PRECLEAN_REMSET_SIZE) {
+            break;
+        }
+    }
+    logging::info() << "Preclean " << rounds << " rounds in " << duration_to_str(gc_clock::now() - start)
+                    << ", remset size " << m_remset.size();
+}
+
+void gc_cms::pace()
+{
+    bool incremental = threads_available() <= 1;
+    m_marker_threads = incremental ? 0 : m_pacer.marker_threads(threads_available() - 1);
+    double trigger = m_pacer.mark_trigger(m_marker_threads);
+    get_heap().set_mark_trigger(trigger);
+
+    logging::info() << "Next marking starts at " << (int) (100 * trigger) << "% of the heap limit"
+                    << " with " << m_marker_threads << " marker threads";
+}
+
 gc_info gc_cms::info() const
 {
     static gc_info inf = {
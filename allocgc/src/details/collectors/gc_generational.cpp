@@ -0,0 +1,238 @@
+#include <liballocgc/details/collectors/gc_generational.hpp>
+
+#include <algorithm>
+
+#include <liballocgc/details/gc_unsafe_scope.hpp>
+#include <liballocgc/details/threads/world_snapshot.hpp>
+#include <liballocgc/details/allocators/gc_nursery.hpp>
+#include <liballocgc/details/allocators/gc_pool_descriptor.hpp>
+#include <liballocgc/details/allocators/memory_index.hpp>
+
+namespace allocgc { namespace details { namespace collectors {
+
+const double gc_generational::MAJOR_THRESHOLD = 0.8;
+
+gc_generational::gc_generational()
+    : gc_core(nullptr)
+    , m_major_requested(false)
+    , m_sticky_marks(false)
+{
+    get_heap().set_nursery_size(allocators::gc_nursery::DEFAULT_SIZE);
+}
+
+void gc_generational::register_handle_slow(gc_handle& handle)
+{
+    gc_unsafe_scope unsafe_scope;
+    remember_slot(reinterpret_cast<byte*>(&handle));
+}
+
+void gc_generational::remember_slot(byte* slot)
+{
+    using namespace allocators;
+
+    if (memory_index::heap_card_table().dirty(slot) || !memory_index::get_descriptor(slot).is_gc_heap_descriptor()) {
+        return;
+    }
+    // slots of the young cells are traced by the minor collection anyway, promoted cells are rescanned after it
+    if (!is_young(memory_index::get_gc_cell(slot))) {
+        m_slots.add(slot);
+    }
+}
+
+void gc_generational::set_nursery_size(size_t size)
+{
+    get_heap().set_nursery_size(size);
+}
+
+void gc_generational::set_sticky_marks(bool sticky)
+{
+    get_heap().set_sticky_marks(sticky);
+    m_sticky_marks = sticky;
+}
+
+gc_runstat gc_generational::gc_impl(const gc_options& options)
+{
+    if (options.kind != gc_kind::COLLECT) {
+        return gc_runstat();
+    }
+
+    if (options.gen == 0 && !m_major_requested) {
+        gc_runstat stats = m_sticky_marks ? sticky_minor_collect() : minor_collect();
+        m_major_requested = get_heap().size() > MAJOR_THRESHOLD * get_heap().limit();
+        return stats;
+    }
+
+    gc_runstat stats = major_collect();
+    m_major_requested = false;
+    shrink();
+    return stats;
+}
+
+gc_runstat gc_generational::minor_collect()
+{
+    auto snapshot = stop_the_world();
+
+    scan_young_slots();
+
+    set_young_only_marking(true);
+    trace_uninit(snapshot);
+    trace_roots(snapshot);
+    trace_pins(snapshot);
+    trace_slots([this] (const gc_trace_callback& cb) {
+        for (gc_handle* slot: m_young_slots) {
+            cb(slot);
+        }
+    });
+    start_concurrent_marking(threads_available());
+    start_marking();
+    set_young_only_marking(false);
+
+    gc_runstat stats;
+    stats.gen = 0;
+    stats.collection = collect_nursery(snapshot, threads_available(), m_young_slots);
+    remember_young_slots();
+    stats.pause = snapshot.time_since_stop_the_world();
+
+    logging::info() << "Minor collection: promoted " << heapsize_to_str(stats.collection.mem_moved)
+                    << ", " << m_young_slots.size() << " old-to-young slots are left uncarded";
+
+    return stats;
+}
+
+gc_runstat gc_generational::sticky_minor_collect()
+{
+    auto snapshot = stop_the_world();
+
+    scan_young_slots();
+
+    trace_uninit(snapshot);
+    trace_roots(snapshot);
+    trace_pins(snapshot);
+    trace_slots([this] (const gc_trace_callback& cb) {
+        for (gc_handle* slot: m_young_slots) {
+            cb(slot);
+        }
+    });
+    start_concurrent_marking(threads_available());
+    start_marking();
+
+    gc_runstat stats;
+    stats.gen = 0;
+    stats.collection = collect_fresh(threads_available());
+    // all the survivors are old now
+    m_young_slots.clear();
+    stats.pause = snapshot.time_since_stop_the_world();
+
+    logging::info() << "Minor collection: freed " << heapsize_to_str(stats.collection.mem_freed);
+
+    return stats;
+}
+
+gc_runstat gc_generational::major_collect()
+{
+    auto snapshot = stop_the_world();
+
+    if (m_sticky_marks) {
+        get_heap().reset_marks();
+    }
+
+    trace_uninit(snapshot);
+    trace_roots(snapshot);
+    trace_pins(snapshot);
+
+    start_concurrent_marking(threads_available());
+    start_marking();
+
+    // nursery is collected in place, so the cards are kept, while the slots of the dead cells are dropped
+    m_slots.flush_buffers();
+    while (m_slots.consume([this] (byte* slot) { m_young_slots.push_back(reinterpret_cast<gc_handle*>(slot)); }) > 0) {}
+    m_young_slots.erase(std::remove_if(m_young_slots.begin(), m_young_slots.end(), [this] (gc_handle* slot) {
+        gc_cell cell = allocators::memory_index::get_gc_cell(reinterpret_cast<byte*>(slot));
+        // in the sticky mark bits mode all the survivors are old
+        return m_sticky_marks || !cell.get_mark() || !points_to_young(slot);
+    }), m_young_slots.end());
+
+    gc_runstat stats;
+    stats.collection = collect(snapshot, threads_available());
+    stats.pause = snapshot.time_since_stop_the_world();
+
+    return stats;
+}
+
+bool gc_generational::is_young(const gc_cell& cell) const
+{
+    if (m_sticky_marks) {
+        return cell.descriptor() && !cell.get_mark();
+    }
+    return allocators::gc_pool_descriptor::is_young_cell(cell);
+}
+
+bool gc_generational::points_to_young(const gc_handle* slot) const
+{
+    byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(*slot);
+    return ptr && is_young(allocators::memory_index::get_gc_cell(ptr));
+}
+
+void gc_generational::scan_young_slots()
+{
+    using namespace allocators;
+
+    m_young_slots.erase(std::remove_if(m_young_slots.begin(), m_young_slots.end(), [this] (gc_handle* slot) {
+        return !points_to_young(slot);
+    }), m_young_slots.end());
+
+    m_slots.flush_buffers();
+    auto remember = [this] (byte* slot) {
+        if (points_to_young(reinterpret_cast<gc_handle*>(slot))) {
+            m_young_slots.push_back(reinterpret_cast<gc_handle*>(slot));
+        }
+    };
+    while (m_slots.consume(remember) > 0) {}
+
+    std::vector<gc_cell> uninit_cells;
+    memory_index::clean_cards([this, &uninit_cells] (const gc_cell& cell) {
+        if (is_young(cell)) {
+            return;
+        }
+        if (!cell.is_init()) {
+            uninit_cells.push_back(cell);
+            return;
+        }
+        cell.trace([this] (gc_handle* slot) {
+            if (points_to_young(slot)) {
+                m_young_slots.push_back(slot);
+            }
+        });
+    });
+    // old object under construction is scanned conservatively, its cards are kept dirty until it is initialized
+    card_table& cards = memory_index::heap_card_table();
+    for (auto& cell: uninit_cells) {
+        byte* cell_end = cell.cell_start() + cell.cell_size();
+        for (byte* it = cell.cell_start(); it < cell_end; it += card_table::CARD_SIZE) {
+            cards.dirty(it);
+        }
+    }
+
+    std::sort(m_young_slots.begin(), m_young_slots.end());
+    m_young_slots.erase(std::unique(m_young_slots.begin(), m_young_slots.end()), m_young_slots.end());
+}
+
+void gc_generational::remember_young_slots()
+{
+    allocators::card_table& cards = allocators::memory_index::heap_card_table();
+    m_young_slots.erase(std::remove_if(m_young_slots.begin(), m_young_slots.end(), [&cards] (gc_handle* slot) {
+        return cards.dirty(reinterpret_cast<const byte*>(slot));
+    }), m_young_slots.end());
+}
+
+gc_info gc_generational::info() const
+{
+    static gc_info inf = {
+            .incremental_flag                = false,
+            .support_concurrent_marking      = false,
+            .support_concurrent_collecting   = false
+    };
+    return inf;
+}
+
+}}}
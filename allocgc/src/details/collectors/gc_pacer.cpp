@@ -0,0 +1,100 @@
+#include <liballocgc/details/collectors/gc_pacer.hpp>
+
+#include <algorithm>
+
+namespace allocgc { namespace details { namespace collectors {
+
+const double gc_pacer::DEFAULT_TRIGGER = 0.6;
+
+const double gc_pacer::MIN_TRIGGER = 0.3;
+
+const double gc_pacer::MAX_TRIGGER = 0.9;
+
+const double gc_pacer::SAFETY_FACTOR = 1.2;
+
+const double gc_pacer::SMOOTHING_FACTOR = 0.5;
+
+gc_pacer::gc_pacer()
+    : m_growth(0)
+    , m_calibrated(false)
+    , m_incremental(false)
+    , m_cycle_threads(0)
+    , m_cycle_heap_size(0)
+    , m_cycle_marked_mem(0)
+    , m_done_heap_size(0)
+{}
+
+void gc_pacer::start_cycle(size_t heap_size, size_t marked_mem, size_t marker_threads)
+{
+    m_cycle_threads    = marker_threads;
+    m_cycle_heap_size  = heap_size;
+    m_cycle_marked_mem = marked_mem;
+    m_done_heap_size   = 0;
+}
+
+void gc_pacer::concurrent_done(size_t heap_size)
+{
+    if (m_done_heap_size == 0) {
+        m_done_heap_size = std::max(heap_size, m_cycle_heap_size);
+    }
+}
+
+void gc_pacer::finish_cycle(size_t heap_size, size_t heap_limit, size_t concurrent_marked_mem, size_t marked_mem)
+{
+    double live_size       = marked_mem - m_cycle_marked_mem;
+    double concurrent_size = concurrent_marked_mem - m_cycle_marked_mem;
+    if (heap_limit == 0 || live_size <= 0) {
+        return;
+    }
+
+    double growth;
+    if (m_done_heap_size > 0) {
+        growth = m_done_heap_size - m_cycle_heap_size;
+    } else {
+        // marking of the rest would take proportionally more time,
+        // if nothing has been marked concurrently then marking should start as early as possible
+        growth = heap_size > m_cycle_heap_size ? heap_size - m_cycle_heap_size : 0;
+        growth = concurrent_size > 0 ? growth * live_size / concurrent_size : heap_limit;
+    }
+    growth /= heap_limit;
+
+    // growth is inversely proportional to the number of marker threads
+    if (m_cycle_threads > 0) {
+        growth *= m_cycle_threads;
+    }
+
+    m_growth = m_calibrated && m_incremental == (m_cycle_threads == 0)
+               ? SMOOTHING_FACTOR * growth + (1.0 - SMOOTHING_FACTOR) * m_growth
+               : growth;
+    m_incremental = m_cycle_threads == 0;
+    m_calibrated  = true;
+}
+
+double gc_pacer::mark_trigger(size_t marker_threads) const
+{
+    if (!m_calibrated || m_incremental != (marker_threads == 0)) {
+        return DEFAULT_TRIGGER;
+    }
+    double trigger = 1.0 - SAFETY_FACTOR * marking_growth(marker_threads);
+    return std::max(MIN_TRIGGER, std::min(trigger, MAX_TRIGGER));
+}
+
+size_t gc_pacer::marker_threads(size_t threads_max) const
+{
+    if (!m_calibrated || m_incremental) {
+        return threads_max;
+    }
+    for (size_t threads = 1; threads < threads_max; ++threads) {
+        if (SAFETY_FACTOR * marking_growth(threads) <= 1.0 - DEFAULT_TRIGGER) {
+            return threads;
+        }
+    }
+    return threads_max;
+}
+
+double gc_pacer::marking_growth(size_t marker_threads) const
+{
+    return marker_threads > 0 ? m_growth / marker_threads : m_growth;
+}
+
+}}}
@@ -0,0 +1,22 @@
+#include <liballocgc/details/collectors/gc_satb.hpp>
+
+namespace allocgc { namespace details { namespace collectors {
+
+void gc_satb::start_barrier()
+{}
+
+void gc_satb::preclean_barrier()
+{
+    // the logged values are drained from the remset by the marking slices of precleaning
+}
+
+void gc_satb::remark(const threads::world_snapshot& snapshot)
+{
+    // the snapshot is complete once the buffers of the barrier are flushed and drained,
+    // stores made during the marking need no rescan
+    trace_uninit(snapshot);
+    trace_pins(snapshot);
+    trace_remset();
+}
+
+}}}
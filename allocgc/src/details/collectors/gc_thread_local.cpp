@@ -0,0 +1,210 @@
+#include <liballocgc/details/collectors/gc_thread_local.hpp>
+
+#include <vector>
+
+#include <liballocgc/details/threads/world_snapshot.hpp>
+#include <liballocgc/details/allocators/gc_nursery.hpp>
+#include <liballocgc/details/allocators/memory_index.hpp>
+
+namespace allocgc { namespace details { namespace collectors {
+
+const double gc_thread_local::GLOBAL_THRESHOLD = 0.8;
+
+gc_thread_local::gc_thread_local()
+    : gc_core(nullptr)
+    , m_global_requested(false)
+{
+    get_heap().set_thread_local_heaps(true);
+    get_heap().set_nursery_size(allocators::gc_nursery::DEFAULT_SIZE);
+}
+
+bool gc_thread_local::is_local_slot(byte* slot)
+{
+    using namespace allocators;
+
+    // stores into the stack of the thread are checked first, since they do not need the memory index lookup
+    threads::gc_thread_descriptor* thread = current_thread();
+    if (thread && thread->is_stack_ptr(reinterpret_cast<gc_handle*>(slot))) {
+        return true;
+    }
+    return memory_index::get_descriptor(slot).is_gc_heap_descriptor() && is_local(slot);
+}
+
+void gc_thread_local::escape(byte* slot, byte* ptr)
+{
+    gc_unsafe_scope unsafe_scope;
+    if (!is_local_slot(slot)) {
+        share_local(allocators::memory_index::get_gc_cell(ptr));
+    }
+}
+
+void gc_thread_local::share_local(const gc_cell& cell)
+{
+    using namespace allocators;
+
+    // local cells are always the cells of the pool chunks
+    trace_local(cell, [] (const gc_cell& cell) {
+        if (gc_pool_descriptor::is_shared_cell(cell)) {
+            return false;
+        }
+        static_cast<gc_pool_descriptor*>(cell.descriptor())->set_shared(cell.cell_start(), true);
+        return true;
+    });
+}
+
+void gc_thread_local::mark_local(const gc_cell& cell)
+{
+    using namespace allocators;
+
+    trace_local(cell, [] (const gc_cell& cell) {
+        if (cell.get_mark() || gc_pool_descriptor::is_shared_cell(cell)) {
+            return false;
+        }
+        cell.set_mark(true);
+        return true;
+    });
+}
+
+template <typename Functor>
+void gc_thread_local::trace_local(const gc_cell& cell, Functor&& take)
+{
+    using namespace allocators;
+
+    std::vector<gc_cell> stack;
+    auto push = [&stack, &take] (const gc_cell& cell) {
+        if (take(cell)) {
+            stack.push_back(cell);
+        }
+    };
+
+    push(cell);
+    while (!stack.empty()) {
+        gc_cell top = stack.back();
+        stack.pop_back();
+        if (top.is_init()) {
+            top.trace([&push] (gc_handle* slot) {
+                byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(*slot);
+                if (ptr) {
+                    push(memory_index::get_gc_cell(ptr));
+                }
+            });
+            continue;
+        }
+        // allocated memory is zeroed, so the words of the object under construction are either null or its data
+        gc_handle* begin = reinterpret_cast<gc_handle*>(top.cell_start());
+        gc_handle* end   = reinterpret_cast<gc_handle*>(top.cell_start() + top.cell_size());
+        for (gc_handle* it = begin; it < end; ++it) {
+            byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(*it);
+            if (!ptr || !memory_index::get_descriptor(ptr).is_gc_heap_descriptor()) {
+                continue;
+            }
+            gc_cell child = memory_index::get_gc_cell(ptr);
+            if (child.is_init()) {
+                push(child);
+            }
+        }
+    }
+}
+
+void gc_thread_local::set_local_heap_size(size_t size)
+{
+    get_heap().set_nursery_size(size);
+}
+
+gc_runstat gc_thread_local::gc(const gc_options& options)
+{
+    if (options.kind == gc_kind::COLLECT && options.gen == 0 && current_thread()
+        && !m_global_requested.load(std::memory_order_relaxed)) {
+        gc_runstat stats = local_collect();
+        account_gc(options, stats);
+        return stats;
+    }
+    return gc_core::gc(options);
+}
+
+gc_runstat gc_thread_local::gc_impl(const gc_options& options)
+{
+    if (options.kind != gc_kind::COLLECT) {
+        return gc_runstat();
+    }
+
+    // threads which have requested the global collection along with another one collect only their own heaps
+    if (options.gen == 0 && current_thread() && !m_global_requested.load(std::memory_order_relaxed)) {
+        return local_collect();
+    }
+
+    gc_runstat stats = global_collect();
+    m_global_requested.store(false, std::memory_order_relaxed);
+    shrink();
+    return stats;
+}
+
+gc_runstat gc_thread_local::local_collect()
+{
+    threads::gc_thread_descriptor* thread = current_thread();
+    assert(thread);
+
+    gc_runstat stats;
+    stats.gen = 0;
+    gc_clock::time_point start = gc_clock::now();
+    {
+        gc_unsafe_scope unsafe_scope;
+
+        thread->trace_uninit([] (byte* obj_start, size_t obj_size) {
+            mark_local(allocators::memory_index::get_gc_cell(obj_start));
+        });
+        thread->trace_roots([] (gc_handle* root) {
+            byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(*root);
+            if (ptr) {
+                mark_local(allocators::memory_index::get_gc_cell(ptr));
+            }
+        });
+        thread->trace_pins([] (byte* ptr) {
+            if (ptr) {
+                mark_local(allocators::memory_index::get_gc_cell(ptr));
+            }
+        });
+
+        stats.collection = get_heap().collect_local(thread->get_tlab());
+    }
+    stats.pause = gc_clock::now() - start;
+
+    if (get_heap().size() > GLOBAL_THRESHOLD * get_heap().limit()) {
+        m_global_requested.store(true, std::memory_order_relaxed);
+    }
+
+    logging::info() << "Local collection: freed " << heapsize_to_str(stats.collection.mem_freed);
+
+    return stats;
+}
+
+gc_runstat gc_thread_local::global_collect()
+{
+    // marks are clear here: local collections unmark their survivors, global ones reset all the marks
+    auto snapshot = stop_the_world();
+
+    trace_uninit(snapshot);
+    trace_roots(snapshot);
+    trace_pins(snapshot);
+
+    start_concurrent_marking(threads_available());
+    start_marking();
+
+    gc_runstat stats;
+    stats.collection = collect(snapshot, threads_available());
+    stats.pause = snapshot.time_since_stop_the_world();
+
+    return stats;
+}
+
+gc_info gc_thread_local::info() const
+{
+    static gc_info inf = {
+            .incremental_flag                = false,
+            .support_concurrent_marking      = false,
+            .support_concurrent_collecting   = false
+    };
+    return inf;
+}
+
+}}}
@@ -1,15 +1,83 @@
 #include <liballocgc/details/collectors/marker.hpp>
 
+#include <algorithm>
+
 #include <liballocgc/details/allocators/memory_index.hpp>
+#include <liballocgc/details/allocators/gc_pool_descriptor.hpp>
+#include <liballocgc/details/allocators/gc_object_descriptor.hpp>
+#include <liballocgc/details/threads/numa_topology.hpp>
+#include <liballocgc/details/utils/static_thread_pool.hpp>
+#include <liballocgc/details/logging.hpp>
 
 namespace allocgc { namespace details { namespace collectors {
 
-marker::marker(packet_manager* manager, remset* rset)
+namespace {
+
+// descriptor classes are final, thus calls through the pointers of the concrete types are not virtual
+
+bool get_mark(const gc_cell& cell)
+{
+    using namespace allocators;
+    switch (cell.descriptor()->kind()) {
+        case gc_descriptor_kind::POOL:
+            return static_cast<gc_pool_descriptor*>(cell.descriptor())->get_mark(cell.get());
+        case gc_descriptor_kind::OBJECT:
+            return static_cast<gc_object_descriptor*>(cell.descriptor())->get_mark(cell.get());
+        default:
+            return cell.get_mark();
+    }
+}
+
+bool is_array_chunk(const gc_cell& item)
+{
+    using namespace allocators;
+    return item.descriptor()->kind() == gc_descriptor_kind::OBJECT
+           && item.get() != static_cast<gc_object_descriptor*>(item.descriptor())->cell_start();
+}
+
+void set_mark(const gc_cell& cell)
+{
+    using namespace allocators;
+    switch (cell.descriptor()->kind()) {
+        case gc_descriptor_kind::POOL:
+            static_cast<gc_pool_descriptor*>(cell.descriptor())->set_mark(cell.get(), true);
+            break;
+        case gc_descriptor_kind::OBJECT:
+            static_cast<gc_object_descriptor*>(cell.descriptor())->set_mark(cell.get(), true);
+            break;
+        default:
+            cell.set_mark(true);
+    }
+}
+
+// test-and-set, so that concurrent workers never push the same cell twice
+bool try_mark(const gc_cell& cell)
+{
+    using namespace allocators;
+    switch (cell.descriptor()->kind()) {
+        case gc_descriptor_kind::POOL:
+            return static_cast<gc_pool_descriptor*>(cell.descriptor())->try_mark(cell.get());
+        case gc_descriptor_kind::OBJECT:
+            return static_cast<gc_object_descriptor*>(cell.descriptor())->try_mark(cell.get());
+        default:
+            return cell.try_mark();
+    }
+}
+
+}
+
+marker::marker(packet_manager* manager, remset* rset, const heap_walker& walker)
     : m_packet_manager(manager)
     , m_remset(rset)
+    , m_heap_walker(walker)
+    , m_roots_packets(manager->numa_nodes_count())
     , m_running_threads_cnt(0)
     , m_concurrent_flag(false)
     , m_done(false)
+    , m_overflow(false)
+    , m_young_only(false)
+    , m_marked_mem(0)
+    , m_mark_time(0)
 {}
 
 marker::~marker()
@@ -19,48 +87,136 @@ marker::~marker()
 
 void marker::add_root(const gc_cell& cell)
 {
-    push_root_to_packet(cell, m_roots_packet);
+    push_root_to_packet(cell, m_roots_packets);
+}
+
+void marker::trace_roots(const std::vector<root_scanner>& scanners, size_t threads_num)
+{
+    if (threads_num <= 1 || scanners.size() <= 1) {
+        auto root_cb = [this] (gc_handle* root) { push_root_to_packet(root, m_roots_packets); };
+        for (auto& scanner: scanners) {
+            scanner(root_cb);
+        }
+        return;
+    }
+
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(scanners.size());
+    for (auto& scanner: scanners) {
+        tasks.emplace_back([this, &scanner] {
+            output_packets_t output_packets(m_packet_manager->numa_nodes_count());
+            scanner([this, &output_packets] (gc_handle* root) { push_root_to_packet(root, output_packets); });
+            push_output_packets(output_packets);
+        });
+    }
+
+    utils::static_thread_pool thread_pool(std::min(threads_num, scanners.size()));
+    thread_pool.run(tasks.begin(), tasks.end());
 }
 
 void marker::trace_remset()
 {
     assert(m_remset);
     m_remset->flush_buffers();
-    auto output_packet = m_packet_manager->pop_output_packet();
-    for (auto it = m_remset->begin(); it != m_remset->end(); ++it) {
-        byte* ptr = *it;
-        if (ptr) {
-            gc_cell cell = allocators::memory_index::get_gc_cell(ptr);
-            cell.set_mark(true);
-            push_root_to_packet(cell, output_packet);
+    output_packets_t output_packets(m_packet_manager->numa_nodes_count());
+    auto push_ptr = [this, &output_packets] (byte* ptr) {
+        gc_cell cell = allocators::memory_index::get_gc_cell(ptr);
+        if (try_mark(cell)) {
+            push_root_to_packet(cell, output_packets);
 
-            logging::debug() << "remset ptr: " << (void*) *it;
+            logging::debug() << "remset ptr: " << (void*) ptr;
         }
-    }
-    m_remset->clear();
-    m_packet_manager->push_packet(std::move(output_packet));
+    };
+    while (m_remset->consume(push_ptr) > 0) {}
+    push_output_packets(output_packets);
+}
+
+void marker::trace_cards()
+{
+    using namespace allocators;
+    output_packets_t output_packets(m_packet_manager->numa_nodes_count());
+    auto visitor = [this, &output_packets] (gc_handle* handle) {
+        trace(handle, output_packets, packet_manager::NO_WORKER);
+    };
+    memory_index::clean_cards([&visitor] (const gc_cell& cell) {
+        if (get_mark(cell) && cell.is_init()) {
+            cell.trace(visitor);
+        }
+    });
+    push_output_packets(output_packets);
 }
 
-void marker::mark()
+void marker::mark(size_t threads_num)
 {
-    if (m_roots_packet) {
-        m_packet_manager->push_packet(std::move(m_roots_packet));
+    // if concurrent marking has been launched then marking cycle started there
+    if (!m_concurrent_flag) {
+        m_mark_start = gc_clock::now();
     }
+    push_output_packets(m_roots_packets);
     m_concurrent_flag = false;
+    // concurrent workers which are still running help to finish the marking, otherwise new helpers are launched
+    if (threads_num > 0 && m_running_threads_cnt.load(std::memory_order_acquire) == 0) {
+        for (auto& worker: m_workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        m_running_threads_cnt += threads_num;
+        m_workers.resize(threads_num);
+        for (auto& worker: m_workers) {
+            worker = std::thread(&marker::worker_routine, this);
+        }
+    }
     ++m_running_threads_cnt;
     worker_routine();
     for (auto& worker: m_workers) {
-        if (worker.get_id() != std::this_thread::get_id()) {
+        if (worker.joinable() && worker.get_id() != std::this_thread::get_id()) {
             worker.join();
         }
     }
+    m_packet_manager->detach_workers();
+    // rescan may overflow again, but every round marks at least the cells dropped by the previous one
+    while (m_overflow.exchange(false, std::memory_order_acq_rel)) {
+        rescan_heap();
+        ++m_running_threads_cnt;
+        worker_routine();
+        m_packet_manager->detach_workers();
+    }
+    m_mark_time += gc_clock::now() - m_mark_start;
 }
 
-void marker::concurrent_mark(size_t threads_num)
+void marker::set_young_only(bool young_only)
+{
+    m_young_only = young_only;
+}
+
+void marker::overflow(const gc_cell& cell)
 {
-    if (m_roots_packet) {
-        m_packet_manager->push_packet(std::move(m_roots_packet));
+    // array of the dropped chunk is already marked, thus it will be rescanned as a whole
+    if (!is_array_chunk(cell) && !get_mark(cell)) {
+        set_mark(cell);
     }
+    m_overflow.store(true, std::memory_order_release);
+}
+
+void marker::rescan_heap()
+{
+    assert(m_heap_walker);
+    logging::info() << "Mark stack overflow, rescan the heap";
+    output_packets_t output_packets(m_packet_manager->numa_nodes_count());
+    auto visitor = [this, &output_packets] (gc_handle* handle) {
+        trace(handle, output_packets, packet_manager::NO_WORKER);
+    };
+    m_heap_walker([&visitor] (const gc_cell& cell) {
+        cell.trace(visitor);
+    });
+    push_output_packets(output_packets);
+}
+
+void marker::concurrent_mark(size_t threads_num)
+{
+    m_mark_start = gc_clock::now();
+    push_output_packets(m_roots_packets);
     m_concurrent_flag = true;
     m_running_threads_cnt = threads_num;
     m_workers.resize(threads_num);
@@ -69,96 +225,223 @@ void marker::concurrent_mark(size_t threads_num)
     }
 }
 
+bool marker::mark_increment(size_t budget)
+{
+    size_t numa_node = threads::numa_topology::current_node();
+    output_packets_t output_packets(m_packet_manager->numa_nodes_count());
+    size_t marked_mem = 0;
+    while (marked_mem < budget) {
+        auto input_packet = m_packet_manager->pop_input_packet(numa_node);
+        if (!input_packet) {
+            // like the workers, slice takes cells from the remset only when there are no packets
+            size_t popped = pop_remset(output_packets, packet_manager::NO_WORKER);
+            bool remset_drained = popped == 0;
+            // cells which are already marked still cost something, otherwise slice can spin on the remset
+            marked_mem += popped * sizeof(byte*);
+            push_output_packets(output_packets);
+            input_packet = m_packet_manager->pop_input_packet(numa_node);
+            if (!input_packet && remset_drained) {
+                break;
+            } else if (!input_packet) {
+                continue;
+            }
+        }
+        while (!input_packet->is_empty() && marked_mem < budget) {
+            marked_mem += scan(input_packet->pop(), output_packets, packet_manager::NO_WORKER);
+        }
+        // the rest of the packet is left for the next slice
+        m_packet_manager->push_packet(std::move(input_packet));
+    }
+    push_output_packets(output_packets);
+    m_marked_mem.fetch_add(marked_mem, std::memory_order_relaxed);
+    return marked_mem >= budget;
+}
+
+size_t marker::pop_remset(output_packets_t& output_packets, size_t worker_id)
+{
+    if (!m_remset) {
+        return 0;
+    }
+    return m_remset->consume([this, &output_packets, worker_id] (byte* ptr) {
+        gc_cell cell = allocators::memory_index::get_gc_cell(ptr);
+        if (try_mark(cell)) {
+            push_to_packet(cell, output_packets, worker_id);
+        }
+    });
+}
+
 void marker::worker_routine()
 {
-    auto input_packet = m_packet_manager->pop_input_packet();
-    packet_manager::mark_packet_handle output_packet = nullptr;
+    size_t numa_node = threads::numa_topology::current_node();
+    size_t worker_id = m_packet_manager->attach_worker(numa_node);
+    auto input_packet = m_packet_manager->pop_input_packet(numa_node, worker_id);
+    output_packets_t output_packets(m_packet_manager->numa_nodes_count());
+    prefetch_ring ring;
+    size_t marked_mem = 0;
     while (true) {
         while (!input_packet) {
 
-            if (m_remset && output_packet) {
-                for (size_t i = 0; i < POP_REMSET_COUNT; ++i) {
-                    byte* ptr = m_remset->get();
-                    if (ptr) {
-                        push_to_packet(allocators::memory_index::get_gc_cell(ptr), output_packet);
-                    } else {
-                        break;
-                    }
-                }
-
-                input_packet = m_packet_manager->pop_input_packet();
-                if (input_packet) {
-                    break;
-                }
-            }
+            pop_remset(output_packets, worker_id);
 
-            if (output_packet) {
-                m_packet_manager->push_packet(std::move(output_packet));
+            // idle worker should not hold any work
+            push_output_packets(output_packets, worker_id);
+            input_packet = m_packet_manager->pop_input_packet(numa_node, worker_id);
+            if (input_packet) {
+                break;
             }
-            if (m_packet_manager->is_no_input() || m_done.load(std::memory_order_acquire)) {
-//                    if (--m_running_threads_cnt == 0 && m_concurrent_flag) {
-//                            gc_initiation_point(initiation_point_type::CONCURRENT_MARKING_FINISHED,
-//                                                initiation_point_data::create_empty_data());
-//                    }
+
+            if (m_done.load(std::memory_order_acquire) || m_packet_manager->try_terminate()) {
+                m_running_threads_cnt.fetch_sub(1, std::memory_order_acq_rel);
                 return;
             }
 
-            std::this_thread::yield();
-            input_packet = m_packet_manager->pop_input_packet();
+            input_packet = m_packet_manager->pop_input_packet(numa_node, worker_id);
         }
-        if (!output_packet) {
-            output_packet = m_packet_manager->pop_output_packet();
-        }
-        auto trace_cb = [this, &output_packet] (gc_handle* handle) {
-            trace(handle, output_packet);
-        };
+        gc_cell cell;
         while (!input_packet->is_empty()) {
-            gc_cell cell = input_packet->pop();
-            cell.trace(gc_trace_callback{std::ref(trace_cb)});
+            if (ring.push(input_packet->pop(), cell)) {
+                marked_mem += scan(cell, output_packets, worker_id);
+            }
         }
+        while (ring.pop(cell)) {
+            marked_mem += scan(cell, output_packets, worker_id);
+        }
+        // marked memory is published per packet, so that the progress of concurrent marking can be observed
+        m_marked_mem.fetch_add(marked_mem, std::memory_order_relaxed);
+        marked_mem = 0;
 
         auto empty_packet = std::move(input_packet);
-        input_packet = m_packet_manager->pop_input_packet();
-        m_packet_manager->push_packet(std::move(empty_packet));
+        input_packet = m_packet_manager->pop_input_packet(numa_node, worker_id);
+        m_packet_manager->push_packet(std::move(empty_packet), worker_id);
     }
 }
 
-void marker::push_root_to_packet(const gc_cell& cell, packet_manager::mark_packet_handle& output_packet)
+size_t marker::marked_mem() const
 {
-    if (!output_packet) {
-        output_packet = m_packet_manager->pop_output_packet();
-    } else if (output_packet->is_full()) {
+    return m_marked_mem.load(std::memory_order_relaxed);
+}
+
+gc_clock::duration marker::mark_time() const
+{
+    return m_mark_time;
+}
+
+bool marker::concurrent_done() const
+{
+    return m_running_threads_cnt.load(std::memory_order_acquire) == 0;
+}
+
+size_t marker::cell_numa_node(const gc_cell& cell) const
+{
+    size_t nodes_count = m_packet_manager->numa_nodes_count();
+    return nodes_count > 1 ? cell.descriptor()->numa_node() % nodes_count : 0;
+}
+
+void marker::push_root_to_packet(const gc_cell& cell, output_packets_t& output_packets)
+{
+    size_t numa_node = cell_numa_node(cell);
+    auto& output_packet = output_packets[numa_node];
+    if (output_packet && output_packet->is_full()) {
         m_packet_manager->push_packet(std::move(output_packet));
-        output_packet = m_packet_manager->pop_output_packet();
+    }
+    if (!output_packet) {
+        output_packet = m_packet_manager->pop_output_packet(numa_node);
+    }
+    if (!output_packet) {
+        overflow(cell);
+        return;
     }
     output_packet->push(cell);
 }
 
-void marker::push_to_packet(const gc_cell& cell, packet_manager::mark_packet_handle& output_packet)
+void marker::push_root_to_packet(gc_handle* root, output_packets_t& output_packets)
 {
-    if (output_packet->is_full()) {
-        size_t attempts = 0;
-        do {
-            auto new_packet = m_packet_manager->pop_output_packet();
-            m_packet_manager->push_packet(std::move(output_packet));
-            output_packet = std::move(new_packet);
-            ++attempts;
-        } while (!output_packet && attempts < POP_OUTPUT_ATTEMPTS);
-        if (attempts == POP_OUTPUT_ATTEMPTS) {
-            throw marking_overflow_exception();
+    byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(*root);
+    if (ptr) {
+        gc_cell cell = allocators::memory_index::get_gc_cell(ptr);
+        if (!is_traced(cell)) {
+            return;
         }
+        set_mark(cell);
+        push_root_to_packet(cell, output_packets);
+
+        logging::debug() << "root: " << (void*) root;
+    }
+}
+
+void marker::push_to_packet(const gc_cell& cell, output_packets_t& output_packets, size_t worker_id)
+{
+    size_t numa_node = cell_numa_node(cell);
+    auto& output_packet = output_packets[numa_node];
+    if (output_packet && output_packet->is_full()) {
+        m_packet_manager->push_packet(std::move(output_packet), worker_id);
+    }
+    if (!output_packet) {
+        output_packet = m_packet_manager->pop_output_packet(numa_node);
+    }
+    if (!output_packet) {
+        overflow(cell);
+        return;
     }
     output_packet->push(cell);
 }
 
-void marker::trace(gc_handle* handle, packet_manager::mark_packet_handle& output_packet)
+void marker::push_output_packets(output_packets_t& output_packets, size_t worker_id)
+{
+    for (auto& output_packet: output_packets) {
+        if (output_packet) {
+            m_packet_manager->push_packet(std::move(output_packet), worker_id);
+        }
+    }
+}
+
+size_t marker::scan(const gc_cell& item, output_packets_t& output_packets, size_t worker_id)
+{
+    using namespace allocators;
+
+    auto visitor = [this, &output_packets, worker_id] (gc_handle* handle) {
+        trace(handle, output_packets, worker_id);
+    };
+
+    // only cells of large objects can be bigger than the chunk
+    if (item.descriptor()->kind() != gc_descriptor_kind::OBJECT) {
+        item.trace(visitor);
+        return item.cell_size();
+    }
+
+    gc_object_descriptor* descr = static_cast<gc_object_descriptor*>(item.descriptor());
+    byte* cell_start = descr->cell_start();
+    byte* obj_start  = gc_box::get_obj_start(cell_start);
+    const gc_type_meta* type_meta = gc_box::get_type_meta(cell_start);
+    size_t obj_size  = type_meta->type_size();
+    size_t obj_cnt   = gc_box::get_obj_count(cell_start);
+    size_t chunk_cnt = obj_size < ARRAY_CHUNK_SIZE ? ARRAY_CHUNK_SIZE / obj_size : 1;
+
+    if (item.get() != cell_start) {
+        size_t obj_begin = (item.get() - obj_start) / obj_size;
+        size_t obj_end   = std::min(obj_begin + chunk_cnt, obj_cnt);
+        gc_box::trace(cell_start, obj_begin, obj_end, visitor);
+        return (obj_end - obj_begin) * obj_size;
+    }
+
+    if (obj_cnt <= chunk_cnt || type_meta->offsets().empty()) {
+        gc_box::trace(cell_start, visitor);
+        return descr->cell_size();
+    }
+
+    for (size_t i = 0; i < obj_cnt; i += chunk_cnt) {
+        push_to_packet(gc_cell::from_cell_start(obj_start + i * obj_size, descr), output_packets, worker_id);
+    }
+    return descr->cell_size() - obj_cnt * obj_size;
+}
+
+void marker::trace(gc_handle* handle, output_packets_t& output_packets, size_t worker_id)
 {
     byte* ptr = gc_handle_access::get<std::memory_order_acquire>(*handle);
     if (ptr) {
         gc_cell cell = allocators::memory_index::get_gc_cell(ptr);
-        if (!cell.get_mark()) {
-            cell.set_mark(true);
-            push_to_packet(cell, output_packet);
+        if (is_traced(cell) && try_mark(cell)) {
+            push_to_packet(cell, output_packets, worker_id);
         }
     }
 }
@@ -4,4 +4,12 @@ namespace allocgc { namespace details { namespace allocators {
 
 index_tree memory_index::indexer{};
 
-}}}
\ No newline at end of file
+page_table memory_index::heap_table{};
+
+mark_bitmap memory_index::heap_marks{};
+
+card_table memory_index::heap_cards{};
+
+std::atomic<bool> memory_index::heap_overflow{false};
+
+}}}
@@ -1,7 +1,15 @@
 #include <liballocgc/details/collectors/packet_manager.hpp>
 
 #include <cassert>
+#include <limits>
+#include <new>
+#include <thread>
 
+#include <sys/mman.h>
+
+#include <liballocgc/details/allocators/sys_allocator.hpp>
+
+#include <liballocgc/details/threads/numa_topology.hpp>
 #include <liballocgc/details/utils/make_unique.hpp>
 #include <liballocgc/gc_common.hpp>
 
@@ -9,6 +17,7 @@ namespace allocgc { namespace details { namespace collectors {
 
 mark_packet::mark_packet()
     : m_size(0)
+    , m_numa_node(0)
     , m_next(nullptr)
 { }
 
@@ -44,77 +53,285 @@ bool mark_packet::is_empty() const
     return m_size == 0;
 }
 
-packet_manager::packet_pool::packet_pool()
-    : m_head(nullptr)
+size_t mark_packet::numa_node() const
+{
+    return m_numa_node;
+}
+
+const size_t packet_manager::NO_WORKER = std::numeric_limits<size_t>::max();
+
+packet_manager::packet_pool::packet_pool(mark_packet* storage)
+    : m_storage(storage)
+    , m_head(NULL_IDX)
     , m_size(0)
 {}
 
+void packet_manager::packet_pool::set_storage(mark_packet* storage)
+{
+    m_storage = storage;
+}
+
 void packet_manager::packet_pool::push(mark_packet_handle packet)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    packet->m_next = m_head;
-    m_head = packet.release();
-    ++m_size;
+    assert(m_storage);
+    mark_packet* p = packet.release();
+    std::uint64_t idx = (p - m_storage) + 1;
+    std::uint64_t head = m_head.load(std::memory_order_relaxed);
+    do {
+        std::uint64_t head_idx = head & IDX_MASK;
+        p->m_next.store(head_idx == NULL_IDX ? nullptr : &m_storage[head_idx - 1], std::memory_order_relaxed);
+    } while (!m_head.compare_exchange_weak(head, make_head(idx, head), std::memory_order_release, std::memory_order_relaxed));
+    m_size.fetch_add(1, std::memory_order_relaxed);
 }
 
 packet_manager::mark_packet_handle packet_manager::packet_pool::pop()
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    if (m_size == 0) {
-        return nullptr;
-    }
-    mark_packet* packet = m_head;
-    m_head = m_head->m_next;
-    --m_size;
+    assert(m_storage);
+    std::uint64_t head = m_head.load(std::memory_order_acquire);
+    mark_packet* packet;
+    do {
+        std::uint64_t head_idx = head & IDX_MASK;
+        if (head_idx == NULL_IDX) {
+            return nullptr;
+        }
+        packet = &m_storage[head_idx - 1];
+        mark_packet* next = packet->m_next.load(std::memory_order_relaxed);
+        std::uint64_t next_idx = next ? (next - m_storage) + 1 : NULL_IDX;
+        if (m_head.compare_exchange_weak(head, make_head(next_idx, head),
+                                         std::memory_order_acquire, std::memory_order_acquire)) {
+            break;
+        }
+    } while (true);
+    m_size.fetch_sub(1, std::memory_order_relaxed);
     return mark_packet_handle(packet);
 }
 
 size_t packet_manager::packet_pool::size() const
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_size;
+    return m_size.load(std::memory_order_relaxed);
+}
+
+std::uint64_t packet_manager::packet_pool::make_head(std::uint64_t idx, std::uint64_t prev_head)
+{
+    std::uint64_t tag = (prev_head >> TAG_SHIFT) + 1;
+    return idx | (tag << TAG_SHIFT);
 }
 
 packet_manager::packet_manager()
+    : packet_manager(threads::numa_topology::nodes_count())
+{}
+
+packet_manager::packet_manager(size_t numa_nodes_count, size_t max_packets_count)
+    : m_packets_storage(nullptr)
+    , m_packets_count(0)
+    , m_max_packets_count(max_packets_count)
+    , m_storage_size(allocators::sys_allocator::align_size(max_packets_count * sizeof(mark_packet)))
+    , m_full_packets(numa_nodes_count)
+    , m_partial_packets(numa_nodes_count)
+    , m_attached_cnt(0)
+    , m_idle_cnt(0)
+{
+    assert(numa_nodes_count > 0);
+    assert(max_packets_count > 0);
+
+    // only touched pages of the arena are backed by physical memory
+    void* storage = mmap(nullptr, m_storage_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (storage == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    m_packets_storage = reinterpret_cast<mark_packet*>(storage);
+
+    m_empty_packets.set_storage(m_packets_storage);
+    for (auto& pool: m_full_packets) {
+        pool.set_storage(m_packets_storage);
+    }
+    for (auto& pool: m_partial_packets) {
+        pool.set_storage(m_packets_storage);
+    }
+    grow();
+}
+
+packet_manager::~packet_manager()
+{
+    munmap(m_packets_storage, m_storage_size);
+}
+
+bool packet_manager::grow()
+{
+    std::lock_guard<std::mutex> lock(m_grow_mutex);
+    size_t packets_count = m_packets_count.load(std::memory_order_relaxed);
+    // someone else has grown the arena while we were waiting for the lock
+    if (m_empty_packets.size() > 0) {
+        return true;
+    }
+    if (packets_count == m_max_packets_count) {
+        return false;
+    }
+    size_t grow_count = m_max_packets_count - packets_count;
+    if (grow_count > PACKETS_COUNT) {
+        grow_count = PACKETS_COUNT;
+    }
+    m_packets_count.store(packets_count + grow_count, std::memory_order_release);
+    for (size_t i = packets_count; i < packets_count + grow_count; ++i) {
+        m_empty_packets.push(mark_packet_handle(new (&m_packets_storage[i]) mark_packet()));
+    }
+    return true;
+}
+
+size_t packet_manager::attach_worker(size_t numa_node)
+{
+    size_t worker_id = m_attached_cnt.fetch_add(1, std::memory_order_acq_rel);
+    if (worker_id >= MAX_WORKERS_COUNT) {
+        return NO_WORKER;
+    }
+    assert(m_worker_queues[worker_id].m_deque.empty());
+    m_worker_queues[worker_id].m_numa_node = numa_node % numa_nodes_count();
+    return worker_id;
+}
+
+void packet_manager::detach_workers()
 {
-    for (auto& packet: m_packets_storage) {
-        m_empty_packets.push(mark_packet_handle(&packet));
+    m_attached_cnt.store(0, std::memory_order_release);
+    m_idle_cnt.store(0, std::memory_order_release);
+}
+
+packet_manager::mark_packet_handle packet_manager::pop_input_packet(size_t numa_node, size_t worker_id)
+{
+    if (worker_id != NO_WORKER) {
+        mark_packet* packet = m_worker_queues[worker_id].m_deque.pop();
+        if (packet) {
+            return mark_packet_handle(packet);
+        }
+    }
+
+    size_t nodes_count = numa_nodes_count();
+    numa_node %= nodes_count;
+    for (size_t i = 0; i < nodes_count; ++i) {
+        auto input_packet = pop_node_input_packet((numa_node + i) % nodes_count);
+        if (input_packet) {
+            return input_packet;
+        }
     }
+
+    return steal_packet(worker_id);
 }
 
-packet_manager::mark_packet_handle packet_manager::pop_input_packet()
+packet_manager::mark_packet_handle packet_manager::pop_node_input_packet(size_t numa_node)
 {
-    auto input_packet = m_full_packets.pop();
+    auto input_packet = m_full_packets[numa_node].pop();
     if (!input_packet) {
-        input_packet = m_partial_packets.pop();
+        input_packet = m_partial_packets[numa_node].pop();
     }
     return input_packet;
 }
 
-packet_manager::mark_packet_handle packet_manager::pop_output_packet()
+packet_manager::mark_packet_handle packet_manager::steal_packet(size_t worker_id)
 {
+    size_t workers_count = attached_workers_count();
+    size_t start = worker_id == NO_WORKER ? 0 : worker_id + 1;
+    for (size_t i = 0; i < workers_count; ++i) {
+        size_t victim = (start + i) % workers_count;
+        if (victim == worker_id) {
+            continue;
+        }
+        mark_packet* packet = m_worker_queues[victim].m_deque.steal();
+        if (packet) {
+            return mark_packet_handle(packet);
+        }
+    }
+    return nullptr;
+}
+
+packet_manager::mark_packet_handle packet_manager::pop_output_packet(size_t numa_node)
+{
+    numa_node %= numa_nodes_count();
     auto output_packet = m_empty_packets.pop();
     if (!output_packet) {
-        output_packet = m_partial_packets.pop();
+        output_packet = m_partial_packets[numa_node].pop();
+    }
+    while (!output_packet && grow()) {
+        output_packet = m_empty_packets.pop();
+    }
+    if (output_packet) {
+        output_packet->m_numa_node = numa_node;
     }
     return output_packet;
 }
 
-void packet_manager::push_packet(mark_packet_handle packet)
+void packet_manager::push_packet(mark_packet_handle packet, size_t worker_id)
 {
+    size_t numa_node = packet->numa_node();
     if (packet->is_empty()) {
         m_empty_packets.push(std::move(packet));
     } else if (packet->is_partial_full()) {
-        m_partial_packets.push(std::move(packet));
-    } else if (packet->is_almost_full()) {
-        m_full_packets.push(std::move(packet));
+        m_partial_packets[numa_node].push(std::move(packet));
+    } else if (worker_id != NO_WORKER && m_worker_queues[worker_id].m_numa_node == numa_node) {
+        // if the deque is full, the packet is shared via the global pool
+        if (m_worker_queues[worker_id].m_deque.push(packet.get())) {
+            packet.release();
+        } else {
+            m_full_packets[numa_node].push(std::move(packet));
+        }
+    } else {
+        m_full_packets[numa_node].push(std::move(packet));
+    }
+}
+
+bool packet_manager::try_terminate()
+{
+    m_idle_cnt.fetch_add(1, std::memory_order_acq_rel);
+    size_t spins = 0;
+    while (true) {
+        if (has_visible_work()) {
+            m_idle_cnt.fetch_sub(1, std::memory_order_acq_rel);
+            return false;
+        }
+        // idle workers hold no packets, so if all workers are idle then no more work can appear
+        if (m_idle_cnt.load(std::memory_order_acquire) >= m_attached_cnt.load(std::memory_order_acquire)) {
+            return true;
+        }
+        if (++spins >= SPIN_COUNT) {
+            std::this_thread::yield();
+        }
     }
 }
 
+bool packet_manager::has_visible_work() const
+{
+    for (size_t i = 0; i < numa_nodes_count(); ++i) {
+        if (m_full_packets[i].size() > 0 || m_partial_packets[i].size() > 0) {
+            return true;
+        }
+    }
+    size_t workers_count = attached_workers_count();
+    for (size_t i = 0; i < workers_count; ++i) {
+        if (!m_worker_queues[i].m_deque.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t packet_manager::attached_workers_count() const
+{
+    size_t attached_cnt = m_attached_cnt.load(std::memory_order_acquire);
+    return attached_cnt < MAX_WORKERS_COUNT ? attached_cnt : MAX_WORKERS_COUNT;
+}
+
 bool packet_manager::is_no_input() const
 {
-    return m_empty_packets.size() == PACKETS_COUNT;
+    return m_empty_packets.size() == packets_count();
 }
 
-}}}
+size_t packet_manager::numa_nodes_count() const
+{
+    return m_full_packets.size();
+}
 
+size_t packet_manager::packets_count() const
+{
+    return m_packets_count.load(std::memory_order_acquire);
+}
+
+}}}
@@ -1,53 +1,81 @@
 #include <liballocgc/details/collectors/remset.hpp>
 
+#include <sys/mman.h>
+
 #include <cassert>
+#include <new>
+
+#include <liballocgc/details/allocators/sys_allocator.hpp>
 
 namespace allocgc { namespace details { namespace collectors {
 
-void remset::add(byte* ptr)
+namespace {
+std::atomic<std::uint64_t> remsets_count(0);
+
+void* reserve_storage(size_t size)
 {
-    static thread_local ssb_t& ssb = get_ssb();
-    if (ssb.is_full()) {
-        flush_ssb(ssb);
+    // only touched pages of the arena are backed by physical memory
+    void* storage = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (storage == MAP_FAILED) {
+        throw std::bad_alloc();
     }
-    ssb.push(ptr);
+    return storage;
+}
 }
 
-byte* remset::get()
+remset::remset(size_t max_chunks_count)
+    : m_id(++remsets_count)
+    , m_storage_size(allocators::sys_allocator::align_size(max_chunks_count * sizeof(ssb_chunk)))
+    , m_chunks_storage(reinterpret_cast<ssb_chunk*>(reserve_storage(m_storage_size)))
+    , m_max_chunks_count(max_chunks_count)
+    , m_chunks_count(0)
+    , m_full_chunks(m_chunks_storage)
+    , m_empty_chunks(m_chunks_storage)
+    , m_size(0)
+    , m_overflow_size(0)
 {
-    std::lock_guard<mutex_t> lock(m_hashtable_mutex);
-    if (m_hashtable.empty()) {
-        return nullptr;
-    }
-    auto it = m_hashtable.begin();
-    byte* ptr = *it;
-    m_hashtable.erase(it);
-    return ptr;
+    assert(max_chunks_count > 0);
 }
 
-size_t remset::size() const
+remset::~remset()
 {
-    std::lock_guard<mutex_t> lock(m_hashtable_mutex);
-    return m_hashtable.size();
+    munmap(m_chunks_storage, m_storage_size);
 }
 
-bool remset::empty() const
+void remset::add(byte* ptr)
 {
-    std::lock_guard<mutex_t> lock(m_hashtable_mutex);
-    return m_hashtable.empty();
+    // buffer of the thread is cached along with the id of its owner, since there could be several remsets
+    static thread_local std::uint64_t owner_id = 0;
+    static thread_local ssb_chunk** ssb_slot = nullptr;
+    if (owner_id != m_id) {
+        ssb_slot = &get_ssb();
+        owner_id = m_id;
+    }
+    ssb_chunk*& ssb = *ssb_slot;
+    if (!ssb || ssb->is_full()) {
+        ssb = flush_ssb(ssb);
+        if (!ssb) {
+            // arena is exhausted
+            std::lock_guard<mutex_t> lock(m_overflow_mutex);
+            m_overflow.push_back(ptr);
+            m_overflow_size.store(m_overflow.size(), std::memory_order_relaxed);
+            return;
+        }
+    }
+    ssb->push(ptr);
 }
 
-remset::const_iterator remset::begin() const
+size_t remset::size() const
 {
-    return m_hashtable.begin();
+    return m_size.load(std::memory_order_relaxed) + m_overflow_size.load(std::memory_order_relaxed);
 }
 
-remset::const_iterator remset::end() const
+bool remset::empty() const
 {
-    return m_hashtable.end();
+    return size() == 0;
 }
 
-remset::ssb_t& remset::get_ssb()
+remset::ssb_chunk*& remset::get_ssb()
 {
     std::lock_guard<mutex_t> lock(m_ssb_mutex);
     return m_ssb_map[std::this_thread::get_id()];
@@ -57,51 +85,91 @@ void remset::flush_buffers()
 {
     std::lock_guard<mutex_t> lock(m_ssb_mutex);
     for (auto it = m_ssb_map.begin(); it != m_ssb_map.end(); ++it) {
-        flush_ssb(it->second);
+        ssb_chunk*& ssb = it->second;
+        if (ssb && ssb->m_size > 0) {
+            m_size.fetch_add(ssb->m_size, std::memory_order_relaxed);
+            m_full_chunks.push(ssb);
+            ssb = nullptr;
+        }
     }
 }
 
-void remset::clear()
+remset::ssb_chunk* remset::flush_ssb(ssb_chunk* ssb)
 {
-    std::lock_guard<mutex_t> lock(m_hashtable_mutex);
-    m_hashtable.clear();
+    if (ssb) {
+        m_size.fetch_add(ssb->m_size, std::memory_order_relaxed);
+        m_full_chunks.push(ssb);
+    }
+    ssb_chunk* chunk = m_empty_chunks.pop();
+    return chunk ? chunk : create_chunk();
 }
 
-void remset::flush_ssb(ssb_t& ssb)
+remset::ssb_chunk* remset::create_chunk()
 {
-    std::lock_guard<mutex_t> lock(m_hashtable_mutex);
-    m_hashtable.insert(ssb.begin(), ssb.end());
-    ssb.clear();
+    size_t idx = m_chunks_count.load(std::memory_order_relaxed);
+    do {
+        if (idx == m_max_chunks_count) {
+            return nullptr;
+        }
+    } while (!m_chunks_count.compare_exchange_weak(idx, idx + 1, std::memory_order_relaxed));
+    return new (m_chunks_storage + idx) ssb_chunk();
 }
 
-remset::sequential_store_buffer::sequential_store_buffer()
+remset::ssb_chunk::ssb_chunk()
     : m_size(0)
+    , m_next(nullptr)
 {}
 
-void remset::sequential_store_buffer::push(byte* ptr)
+void remset::ssb_chunk::push(byte* ptr)
 {
     assert(!is_full());
     m_data[m_size++] = ptr;
 }
 
-void remset::sequential_store_buffer::clear()
+bool remset::ssb_chunk::is_full() const
 {
-    m_size = 0;
+    return m_size == SSB_SIZE;
 }
 
-bool remset::sequential_store_buffer::is_full() const
+remset::chunk_pool::chunk_pool(ssb_chunk* storage)
+    : m_storage(storage)
+    , m_head(NULL_IDX)
+{}
+
+void remset::chunk_pool::push(ssb_chunk* chunk)
 {
-    return m_size == SSB_SIZE;
+    std::uint64_t idx = (chunk - m_storage) + 1;
+    std::uint64_t head = m_head.load(std::memory_order_relaxed);
+    do {
+        std::uint64_t head_idx = head & IDX_MASK;
+        chunk->m_next.store(head_idx == NULL_IDX ? nullptr : &m_storage[head_idx - 1], std::memory_order_relaxed);
+    } while (!m_head.compare_exchange_weak(head, make_head(idx, head), std::memory_order_release, std::memory_order_relaxed));
 }
 
-remset::sequential_store_buffer::const_iterator remset::sequential_store_buffer::begin() const
+remset::ssb_chunk* remset::chunk_pool::pop()
 {
-    return m_data;
+    std::uint64_t head = m_head.load(std::memory_order_acquire);
+    ssb_chunk* chunk;
+    do {
+        std::uint64_t head_idx = head & IDX_MASK;
+        if (head_idx == NULL_IDX) {
+            return nullptr;
+        }
+        chunk = &m_storage[head_idx - 1];
+        ssb_chunk* next = chunk->m_next.load(std::memory_order_relaxed);
+        std::uint64_t next_idx = next ? (next - m_storage) + 1 : NULL_IDX;
+        if (m_head.compare_exchange_weak(head, make_head(next_idx, head),
+                                         std::memory_order_acquire, std::memory_order_acquire)) {
+            break;
+        }
+    } while (true);
+    return chunk;
 }
 
-remset::sequential_store_buffer::const_iterator remset::sequential_store_buffer::end() const
+std::uint64_t remset::chunk_pool::make_head(std::uint64_t idx, std::uint64_t prev_head)
 {
-    return m_data + m_size;
+    std::uint64_t tag = (prev_head >> TAG_SHIFT) + 1;
+    return idx | (tag << TAG_SHIFT);
 }
 
 }}}
@@ -1,12 +1,14 @@
 #include <liballocgc/details/collectors/gc_heap.hpp>
 
 #include <cassert>
+#include <algorithm>
 #include <utility>
 
 #include <liballocgc/details/compacting/fix_ptrs.hpp>
 #include <liballocgc/details/compacting/two_finger_compactor.hpp>
 #include <liballocgc/details/threads/gc_thread_manager.hpp>
 #include <liballocgc/details/threads/world_snapshot.hpp>
+#include <liballocgc/details/threads/numa_topology.hpp>
 #include <liballocgc/details/utils/static_thread_pool.hpp>
 #include <liballocgc/details/logging.hpp>
 
@@ -15,6 +17,9 @@ namespace allocgc { namespace details {
 gc_heap::gc_heap(gc_launcher* launcher)
     : m_core_alloc(launcher)
     , m_loa(&m_core_alloc)
+    , m_nursery_enabled(false)
+    , m_sticky_marks(false)
+    , m_thread_local_heaps(false)
 {}
 
 gc_alloc::response gc_heap::allocate(const gc_alloc::request& rqst)
@@ -25,11 +30,31 @@ gc_alloc::response gc_heap::allocate(const gc_alloc::request& rqst)
 
 gc_heap::tlab* gc_heap::allocate_tlab(std::thread::id thrd_id)
 {
+    // tlab is refilled from the page pool of the node the thread is running on
+    size_t numa_node = threads::numa_topology::current_node();
+
     std::lock_guard<std::mutex> lock(m_mutex);
-    return &m_tlab_map.emplace(
+    allocators::gc_nursery* budget = m_sticky_marks ? &m_nursery : nullptr;
+    if (m_thread_local_heaps) {
+        budget = &m_local_budgets.emplace(
+                std::piecewise_construct,
+                std::make_tuple(thrd_id),
+                std::make_tuple(m_nursery.size())
+        ).first->second;
+    }
+    tlab* old_tlab = &m_tlab_map.emplace(
+            std::piecewise_construct,
+            std::make_tuple(thrd_id),
+            std::make_tuple(&m_core_alloc, numa_node, budget)
+    ).first->second;
+    if (!m_nursery_enabled || m_sticky_marks || m_thread_local_heaps) {
+        return old_tlab;
+    }
+    // thread allocates in the nursery, while its old allocator receives only the promoted cells
+    return &m_nursery_map.emplace(
             std::piecewise_construct,
             std::make_tuple(thrd_id),
-            std::make_tuple(&m_core_alloc)
+            std::make_tuple(&m_core_alloc, numa_node, &m_nursery, true)
     ).first->second;
 }
 
@@ -42,15 +67,15 @@ gc_collect_stat gc_heap::collect(
     utils::static_thread_pool thread_pool(threads_available);
 
     gc_collect_stat stat;
-    for (auto& kv: m_tlab_map) {
-        stat += kv.second.collect(frwd, thread_pool);
-    }
+    for_each_tlab([&stat, &frwd, &thread_pool] (so_alloc_t& tlab) {
+        stat += tlab.collect(frwd, thread_pool);
+    });
     stat += m_loa.collect(frwd);
 
     if (stat.mem_moved > 0) {
-        for (auto& kv: m_tlab_map) {
-            kv.second.fix(frwd, thread_pool);
-        }
+        for_each_tlab([&frwd, &thread_pool] (so_alloc_t& tlab) {
+            tlab.fix(frwd, thread_pool);
+        });
         m_loa.fix(frwd);
 
         auto fix_roots_cb = [&frwd] (gc_handle* root) {
@@ -61,10 +86,23 @@ gc_collect_stat gc_heap::collect(
         snapshot.trace_roots(fix_roots_cb);
     }
 
-    for (auto& kv: m_tlab_map) {
-        kv.second.finalize();
+    if (m_sticky_marks) {
+        // survivors of the collection are old
+        for_each_tlab([] (so_alloc_t& tlab) {
+            tlab.unpin();
+        });
+        m_loa.unpin();
+    } else {
+        for_each_tlab([] (so_alloc_t& tlab) {
+            tlab.finalize();
+        });
+        m_loa.finalize();
+    }
+    // young chunks survive the major collection in place
+    m_nursery.reset();
+    for (auto& kv: m_local_budgets) {
+        kv.second.reset();
     }
-    m_loa.finalize();
 
     if (stat.mem_freed < stat.mem_used / 100) {
         m_core_alloc.expand_heap(2);
@@ -76,12 +114,104 @@ gc_collect_stat gc_heap::collect(
     return stat;
 }
 
-gc_memstat gc_heap::stats()
+gc_collect_stat gc_heap::collect_nursery(
+        const threads::world_snapshot& snapshot,
+        size_t threads_available,
+        collectors::static_root_set* static_roots,
+        std::vector<gc_handle*>& young_slots
+) {
+    using namespace allocators;
+
+    compacting::forwarding frwd;
+    // cells are moved by the pool threads, since constructors of the moved objects should not see a mutator thread
+    utils::static_thread_pool thread_pool(std::max(threads_available, (size_t) 1));
+
+    gc_collect_stat stat;
+    for (auto& kv: m_nursery_map) {
+        stat += kv.second.evacuate(m_tlab_map.at(kv.first), frwd, thread_pool);
+    }
+
+    auto fix_roots_cb = [&frwd] (gc_handle* root) {
+        frwd.forward(root);
+    };
+    static_roots->trace(fix_roots_cb);
+    snapshot.trace_roots(fix_roots_cb);
+
+    for (gc_handle* slot: young_slots) {
+        frwd.forward(slot);
+    }
+    young_slots.erase(std::remove_if(young_slots.begin(), young_slots.end(), [] (gc_handle* slot) {
+        return !gc_pool_descriptor::is_young_ptr(gc_handle_access::get<std::memory_order_relaxed>(*slot));
+    }), young_slots.end());
+
+    // only survivors may point to the evacuated cells, the rest of the nursery is garbage
+    for_each_tlab([&frwd, &thread_pool, &young_slots] (so_alloc_t& tlab) {
+        tlab.fix_survivors(frwd, thread_pool, young_slots);
+    });
+
+    for (auto& kv: m_nursery_map) {
+        stat += kv.second.release_evacuated();
+    }
+    m_nursery.reset();
+    m_core_alloc.notify_gc();
+
+    return stat;
+}
+
+gc_collect_stat gc_heap::collect_fresh(size_t threads_available)
 {
-    gc_memstat stat;
+    assert(m_sticky_marks);
+
+    utils::static_thread_pool thread_pool(std::max(threads_available, (size_t) 1));
+
+    gc_collect_stat stat;
     for (auto& kv: m_tlab_map) {
-        stat += kv.second.stats();
+        stat += kv.second.sweep_fresh(thread_pool);
     }
+    // large objects are not swept by chunks, but the old ones are marked anyway
+    compacting::forwarding frwd;
+    stat += m_loa.collect(frwd);
+    m_loa.unpin();
+
+    m_nursery.reset();
+    m_core_alloc.notify_gc();
+
+    return stat;
+}
+
+gc_collect_stat gc_heap::collect_local(tlab* local_heap)
+{
+    assert(m_thread_local_heaps);
+
+    // the tlab is swept by its owner
+    utils::static_thread_pool thread_pool(0);
+    gc_collect_stat stat = local_heap->sweep_local(thread_pool);
+    local_heap->nursery()->reset();
+    return stat;
+}
+
+void gc_heap::reset_marks()
+{
+    for_each_tlab([] (so_alloc_t& tlab) {
+        tlab.finalize();
+    });
+    m_loa.finalize();
+}
+
+void gc_heap::trace_live(const gc_cell_callback& cb)
+{
+    for_each_tlab([&cb] (so_alloc_t& tlab) {
+        tlab.trace_live(cb);
+    });
+    m_loa.trace_live(cb);
+}
+
+gc_memstat gc_heap::stats()
+{
+    gc_memstat stat;
+    for_each_tlab([&stat] (so_alloc_t& tlab) {
+        stat += tlab.stats();
+    });
     stat += m_loa.stats();
     stat.mem_extra += allocators::memory_index::size();
     return stat;
@@ -92,9 +222,43 @@ void gc_heap::shrink()
     m_core_alloc.shrink();
 }
 
+size_t gc_heap::size() const
+{
+    return m_core_alloc.heap_size();
+}
+
+size_t gc_heap::limit() const
+{
+    return m_core_alloc.heap_limit();
+}
+
 void gc_heap::set_limit(size_t limit)
 {
     m_core_alloc.set_heap_limit(limit);
 }
 
-}}
\ No newline at end of file
+void gc_heap::set_mark_trigger(double trigger)
+{
+    m_core_alloc.set_mark_trigger(trigger);
+}
+
+void gc_heap::set_nursery_size(size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_nursery.set_size(size);
+    m_nursery_enabled = true;
+}
+
+void gc_heap::set_sticky_marks(bool sticky)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sticky_marks = sticky;
+}
+
+void gc_heap::set_thread_local_heaps(bool thread_local_heaps)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_thread_local_heaps = thread_local_heaps;
+}
+
+}}
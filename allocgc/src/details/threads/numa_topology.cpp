@@ -0,0 +1,117 @@
+#include <liballocgc/details/threads/numa_topology.hpp>
+
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include <liballocgc/details/utils/system_error.hpp>
+
+namespace allocgc { namespace details { namespace threads {
+
+// nodes mask passed to mbind should fit into a single word
+const size_t numa_topology::MAX_NODES_COUNT = 64;
+
+namespace {
+
+const char* FAKE_NODES_ENV = "ALLOCGC_FAKE_NUMA_NODES";
+const char* ONLINE_NODES_PATH = "/sys/devices/system/node/online";
+
+// MPOL_PREFERRED from <numaif.h>, we do not depend on libnuma
+const int MPOL_PREFERRED_MODE = 1;
+
+size_t read_nodes_count()
+{
+    // file contains list of online nodes, e.g. "0-1" or "0,2"
+    std::ifstream in(ONLINE_NODES_PATH);
+    std::string nodes;
+    if (!(in >> nodes) || nodes.empty()) {
+        return 1;
+    }
+    size_t pos = nodes.find_last_of(",-");
+    size_t last_node = std::strtoul(nodes.c_str() + (pos == std::string::npos ? 0 : pos + 1), nullptr, 10);
+    return std::min(last_node + 1, numa_topology::MAX_NODES_COUNT);
+}
+
+size_t read_fake_nodes_count()
+{
+    const char* env = std::getenv(FAKE_NODES_ENV);
+    if (!env) {
+        return 0;
+    }
+    return std::min<size_t>(std::strtoul(env, nullptr, 10), numa_topology::MAX_NODES_COUNT);
+}
+
+// topology could be requested during static initialization of the collector,
+// so all state is lazily initialized
+size_t real_nodes_count()
+{
+    static const size_t nodes_count = read_nodes_count();
+    return nodes_count;
+}
+
+std::atomic<size_t>& fake_nodes_count()
+{
+    static std::atomic<size_t> nodes_count{read_fake_nodes_count()};
+    return nodes_count;
+}
+
+size_t fake_thread_id()
+{
+    static std::atomic<size_t> threads_count{0};
+    static thread_local size_t thread_id = threads_count++;
+    return thread_id;
+}
+
+}
+
+size_t numa_topology::nodes_count()
+{
+    size_t fake_count = fake_nodes_count().load(std::memory_order_relaxed);
+    return fake_count > 0 ? fake_count : real_nodes_count();
+}
+
+size_t numa_topology::current_node()
+{
+    size_t fake_count = fake_nodes_count().load(std::memory_order_relaxed);
+    if (fake_count > 0) {
+        return fake_thread_id() % fake_count;
+    }
+    if (real_nodes_count() == 1) {
+        return 0;
+    }
+    unsigned cpu  = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) < 0) {
+        return 0;
+    }
+    return std::min<size_t>(node, real_nodes_count() - 1);
+}
+
+bool numa_topology::is_fake()
+{
+    return fake_nodes_count().load(std::memory_order_relaxed) > 0;
+}
+
+void numa_topology::set_fake_nodes_count(size_t count)
+{
+    fake_nodes_count().store(std::min(count, MAX_NODES_COUNT), std::memory_order_relaxed);
+}
+
+void numa_topology::bind_memory(byte* ptr, size_t size, size_t node)
+{
+    if (is_fake() || real_nodes_count() == 1) {
+        return;
+    }
+    assert(node < real_nodes_count());
+    unsigned long nodemask = 1ul << node;
+    long rc = syscall(SYS_mbind, ptr, size, MPOL_PREFERRED_MODE, &nodemask, sizeof(nodemask) * 8, 0);
+    utils::log_system_error(rc, "mbind failed");
+}
+
+}}}
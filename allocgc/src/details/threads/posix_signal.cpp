@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <cstring>
+#include <type_traits>
 
 namespace allocgc { namespace details { namespace threads {
 
@@ -13,13 +14,15 @@ void call_signal_handler()
     }
 }
 
-static thread_local pending_call pcall{call_signal_handler};
+static_assert(std::is_trivially_destructible<pending_call>::value, "pending_call is used as __thread variable");
+
+__thread pending_call posix_signal::pcall{call_signal_handler};
 
 extern "C" {
 void sighandler(int signum)
 {
     assert(signum == posix_signal::SIGNUM);
-    pcall();
+    posix_signal::pcall();
 }
 }
 
@@ -61,16 +64,6 @@ void posix_signal::send(pthread_t thread)
     pthread_kill(thread, SIGNUM);
 }
 
-void posix_signal::lock()
-{
-    pcall.enter_pending_scope();
-}
-
-void posix_signal::unlock()
-{
-    pcall.leave_pending_scope();
-}
-
 void posix_signal::enter_safe_scope()
 {
     pcall.enter_safe_scope();
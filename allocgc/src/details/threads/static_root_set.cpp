@@ -1,5 +1,7 @@
 #include <liballocgc/details/collectors/static_root_set.hpp>
 
+#include <cassert>
+
 namespace allocgc { namespace details { namespace collectors {
 
 void static_root_set::register_root(gc_handle* root)
@@ -36,4 +38,21 @@ void static_root_set::trace(const gc_trace_callback& cb) const
     std::for_each(m_set.begin(), m_set.end(), cb);
 }
 
+size_t static_root_set::shards_count(size_t max_shards) const
+{
+    size_t shards_cnt = m_set.size() / MIN_SHARD_SIZE;
+    return std::max((size_t) 1, std::min(shards_cnt, max_shards));
+}
+
+void static_root_set::trace(const gc_trace_callback& cb, size_t shard, size_t shards_cnt) const
+{
+    assert(shard < shards_cnt);
+    size_t buckets_cnt  = m_set.bucket_count();
+    size_t bucket_begin = buckets_cnt * shard / shards_cnt;
+    size_t bucket_end   = buckets_cnt * (shard + 1) / shards_cnt;
+    for (size_t i = bucket_begin; i < bucket_end; ++i) {
+        std::for_each(m_set.begin(i), m_set.end(i), cb);
+    }
+}
+
 }}}
@@ -112,5 +112,177 @@ void deregister_thread(std::thread::id id)
 
 }
 
+namespace satb {
+
+void gc()
+{
+    gc_options opt;
+    opt.kind = gc_kind::COLLECT;
+    opt.gen  = -1;
+    gc_facade<gc_satb>::initiation_point(details::initiation_point_type::USER_REQUEST, opt);
+}
+
+gc_stat stats()
+{
+    return gc_facade<gc_satb>::stats();
+}
+
+void set_heap_limit(size_t limit)
+{
+    gc_facade<gc_satb>::set_heap_limit(limit);
+}
+
+void set_threads_available(size_t threads_available)
+{
+    gc_facade<gc_satb>::set_threads_available(threads_available);
+}
+
+void register_main_thread()
+{
+    thread_descriptor main_thrd_descr;
+    main_thrd_descr.id = std::this_thread::get_id();
+    main_thrd_descr.native_handle = threads::this_thread_native_handle();
+    main_thrd_descr.stack_addr = threads::get_stack_addr(threads::this_thread_native_handle());
+    main_thrd_descr.stack_size = threads::get_stack_size(threads::this_thread_native_handle());
+    register_thread(main_thrd_descr);
+}
+
+void register_thread(const thread_descriptor& descr)
+{
+    gc_facade<gc_satb>::register_thread(descr);
+}
+
+void deregister_thread(std::thread::id id)
+{
+    gc_facade<gc_satb>::deregister_thread(id);
+}
+
+}
+
+namespace gen {
+
+void gc()
+{
+    gc_options opt;
+    opt.kind = gc_kind::COLLECT;
+    opt.gen  = -1;
+    gc_facade<gc_generational>::initiation_point(details::initiation_point_type::USER_REQUEST, opt);
+}
+
+void minor_gc()
+{
+    gc_options opt;
+    opt.kind = gc_kind::COLLECT;
+    opt.gen  = 0;
+    gc_facade<gc_generational>::initiation_point(details::initiation_point_type::USER_REQUEST, opt);
+}
+
+gc_stat stats()
+{
+    return gc_facade<gc_generational>::stats();
+}
+
+void set_heap_limit(size_t limit)
+{
+    gc_facade<gc_generational>::set_heap_limit(limit);
+}
+
+void set_nursery_size(size_t size)
+{
+    gc_facade<gc_generational>::set_nursery_size(size);
+}
+
+void set_sticky_marks(bool sticky)
+{
+    gc_facade<gc_generational>::set_sticky_marks(sticky);
+}
+
+void set_threads_available(size_t threads_available)
+{
+    gc_facade<gc_generational>::set_threads_available(threads_available);
+}
+
+void register_main_thread()
+{
+    thread_descriptor main_thrd_descr;
+    main_thrd_descr.id = std::this_thread::get_id();
+    main_thrd_descr.native_handle = threads::this_thread_native_handle();
+    main_thrd_descr.stack_addr = threads::get_stack_addr(threads::this_thread_native_handle());
+    main_thrd_descr.stack_size = threads::get_stack_size(threads::this_thread_native_handle());
+    register_thread(main_thrd_descr);
+}
+
+void register_thread(const thread_descriptor& descr)
+{
+    gc_facade<gc_generational>::register_thread(descr);
+}
+
+void deregister_thread(std::thread::id id)
+{
+    gc_facade<gc_generational>::deregister_thread(id);
+}
+
+}
+
+namespace tlh {
+
+void gc()
+{
+    gc_options opt;
+    opt.kind = gc_kind::COLLECT;
+    opt.gen  = -1;
+    gc_facade<gc_thread_local>::initiation_point(details::initiation_point_type::USER_REQUEST, opt);
+}
+
+void local_gc()
+{
+    gc_options opt;
+    opt.kind = gc_kind::COLLECT;
+    opt.gen  = 0;
+    gc_facade<gc_thread_local>::initiation_point(details::initiation_point_type::USER_REQUEST, opt);
+}
+
+gc_stat stats()
+{
+    return gc_facade<gc_thread_local>::stats();
+}
+
+void set_heap_limit(size_t limit)
+{
+    gc_facade<gc_thread_local>::set_heap_limit(limit);
+}
+
+void set_local_heap_size(size_t size)
+{
+    gc_facade<gc_thread_local>::set_local_heap_size(size);
+}
+
+void set_threads_available(size_t threads_available)
+{
+    gc_facade<gc_thread_local>::set_threads_available(threads_available);
+}
+
+void register_main_thread()
+{
+    thread_descriptor main_thrd_descr;
+    main_thrd_descr.id = std::this_thread::get_id();
+    main_thrd_descr.native_handle = threads::this_thread_native_handle();
+    main_thrd_descr.stack_addr = threads::get_stack_addr(threads::this_thread_native_handle());
+    main_thrd_descr.stack_size = threads::get_stack_size(threads::this_thread_native_handle());
+    register_thread(main_thrd_descr);
+}
+
+void register_thread(const thread_descriptor& descr)
+{
+    gc_facade<gc_thread_local>::register_thread(descr);
+}
+
+void deregister_thread(std::thread::id id)
+{
+    gc_facade<gc_thread_local>::deregister_thread(id);
+}
+
+}
+
 }
 
@@ -54,6 +54,18 @@
     using namespace allocgc::cms;
 #endif
 
+#ifdef PRECISE_GC_SATB
+    #include "liballocgc/liballocgc.hpp"
+    using namespace allocgc;
+    using namespace allocgc::satb;
+#endif
+
+#ifdef PRECISE_GC_GEN
+    #include "liballocgc/liballocgc.hpp"
+    using namespace allocgc;
+    using namespace allocgc::gen;
+#endif
+
 #include "../../common/macro.hpp"
 #include "../../common/timer.hpp"
 
@@ -237,13 +249,42 @@ struct GCBench {
         #if defined(BDW_GC)
             cout << "Completed " << GC_get_gc_no() << " collections" << endl;
             cout << "Heap size is " << GC_get_heap_size() << endl;
-        #elif defined(PRECISE_GC_SERIAL) || defined(PRECISE_GC_CMS)
+        #elif defined(PRECISE_GC_SERIAL) || defined(PRECISE_GC_CMS) || defined(PRECISE_GC_SATB) || defined(PRECISE_GC_GEN)
             gc_stat stat = stats();
             cout << "Completed " << stat.gc_count << " collections" << endl;
             cout << "Time spent in gc " << std::chrono::duration_cast<std::chrono::milliseconds>(stat.gc_time).count() << " ms" << endl;
             cout << "Average pause time " << std::chrono::duration_cast<std::chrono::microseconds>(stat.gc_time / stat.gc_count).count() << " us" << endl;
+            auto mark_us = std::chrono::duration_cast<std::chrono::microseconds>(stat.mark_time).count();
+            cout << "Mark throughput " << (mark_us > 0 ? stat.mark_mem / mark_us : 0) << " MB/s" << endl;
+            #ifdef PRECISE_GC_GEN
+                print_pauses("Minor", stat.minor_pauses);
+                print_pauses("Major", stat.major_pauses);
+            #endif
         #endif
     }
+
+    #ifdef PRECISE_GC_GEN
+    static void print_pauses(const char* name, const gc_pause_histogram& hist) {
+        cout << name << " pauses: " << hist.count;
+        if (hist.count == 0) {
+            cout << endl;
+            return;
+        }
+        cout << ", average " << std::chrono::duration_cast<std::chrono::microseconds>(hist.total / hist.count).count() << " us"
+             << ", max " << std::chrono::duration_cast<std::chrono::microseconds>(hist.longest).count() << " us" << endl;
+        for (size_t i = 0; i < gc_pause_histogram::BUCKETS_COUNT; ++i) {
+            if (hist.buckets[i] == 0) {
+                continue;
+            }
+            if (i + 1 < gc_pause_histogram::BUCKETS_COUNT) {
+                cout << "\t< " << std::chrono::duration_cast<std::chrono::microseconds>(gc_pause_histogram::bucket_bound(i)).count() << " us: ";
+            } else {
+                cout << "\tlonger: ";
+            }
+            cout << hist.buckets[i] << endl;
+        }
+    }
+    #endif
 };
 
 int main (int argc, const char* argv[])
@@ -251,6 +292,10 @@ int main (int argc, const char* argv[])
     int ttype = 0;
     bool compacting_flag = false;
     bool incremental_flag = false;
+    #ifdef PRECISE_GC_GEN
+        bool sticky_flag = false;
+        size_t nursery_size = 0;
+    #endif
     for (int i = 1; i < argc; ++i) {
         auto arg = std::string(argv[i]);
         if (arg == "--incremental") {
@@ -262,10 +307,25 @@ int main (int argc, const char* argv[])
         } else if (arg == "--bottom-up") {
             ttype |= BOTTOM_UP;
         }
+        #ifdef PRECISE_GC_GEN
+            else if (arg == "--nursery-size" && i + 1 < argc) {
+                nursery_size = std::stoul(argv[++i]) * 1024 * 1024;
+            } else if (arg == "--sticky") {
+                sticky_flag = true;
+            }
+        #endif
     }
 
-    #if defined(PRECISE_GC_SERIAL) || defined(PRECISE_GC_CMS)
+    #if defined(PRECISE_GC_SERIAL) || defined(PRECISE_GC_CMS) || defined(PRECISE_GC_SATB) || defined(PRECISE_GC_GEN)
+        #ifdef PRECISE_GC_GEN
+            set_sticky_marks(sticky_flag);
+        #endif
         register_main_thread();
+        #ifdef PRECISE_GC_GEN
+            if (nursery_size > 0) {
+                set_nursery_size(nursery_size);
+            }
+        #endif
 //        set_heap_limit(36 * 1024 * 1024);
 //        enable_logging(gc_loglevel::DEBUG);
     #elif defined(BDW_GC)
@@ -189,6 +189,8 @@ int main(int argc, const char* argv[])
     std::cout << "Completed " << stat.gc_count << " collections" << std::endl;
     std::cout << "Time spent in gc " << std::chrono::duration_cast<std::chrono::milliseconds>(stat.gc_time).count() << " ms" << std::endl;
     std::cout << "Average pause time " << std::chrono::duration_cast<std::chrono::microseconds>(stat.gc_time / stat.gc_count).count() << " us" << std::endl;
+    auto mark_us = std::chrono::duration_cast<std::chrono::microseconds>(stat.mark_time).count();
+    std::cout << "Mark throughput " << (mark_us > 0 ? stat.mark_mem / mark_us : 0) << " MB/s" << std::endl;
 #endif
 
     return 0;
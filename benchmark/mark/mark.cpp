@@ -0,0 +1,272 @@
+// Marking microbenchmark.
+//
+// Builds a large binary tree and measures throughput of the marker on it,
+// and throughput of descriptor lookups in the flat page table versus the index tree.
+// Measures concurrent indexing and deindexing of pages in the index tree.
+// Also compares tracing of a large array by the offsets vector versus the pointers mask of the type.
+//
+// Run it with ALLOCGC_HEAP_RESERVE=0 to measure marking with the index tree only.
+
+#include <string>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+#include <liballocgc/liballocgc.hpp>
+#include <liballocgc/details/collectors/marker.hpp>
+#include <liballocgc/details/collectors/packet_manager.hpp>
+#include <liballocgc/details/allocators/memory_index.hpp>
+#include <liballocgc/details/allocators/gc_box.hpp>
+#include <liballocgc/details/allocators/index_tree.hpp>
+#include <liballocgc/details/allocators/page_table.hpp>
+#include <liballocgc/details/allocators/reserved_range_allocator.hpp>
+
+#include "../../common/timer.hpp"
+
+using namespace allocgc;
+using namespace allocgc::serial;
+using namespace allocgc::details;
+
+using namespace std;
+
+static const int kTreeDepth   = 20;
+static const int kIterations  = 5;
+static const size_t kArraySize = 1 << 20;
+static const size_t kIndexThreads = 4;
+static const size_t kIndexRounds  = 64;
+
+struct Node
+{
+    gc_ptr<Node> left;
+    gc_ptr<Node> right;
+};
+
+ALLOCGC_DECLARE_TYPE_LAYOUT(Node, offsetof(Node, left), offsetof(Node, right))
+
+gc_ptr<Node> MakeTree(int depth)
+{
+    gc_ptr<Node> node = gc_new<Node>();
+    if (depth > 0) {
+        gc_pin<Node> pinned = node.pin();
+        pinned->left  = MakeTree(depth - 1);
+        pinned->right = MakeTree(depth - 1);
+    }
+    return node;
+}
+
+void CollectCells(const gc_ptr<Node>& node, vector<byte*>& cells)
+{
+    if (!node) {
+        return;
+    }
+    gc_pin<Node> pinned = node.pin();
+    cells.push_back(reinterpret_cast<byte*>(pinned.get()));
+    CollectCells(pinned->left, cells);
+    CollectCells(pinned->right, cells);
+}
+
+double MarkThroughput(byte* root, const vector<byte*>& cells)
+{
+    for (byte* ptr: cells) {
+        allocators::memory_index::get_gc_cell(ptr).set_mark(false);
+    }
+
+    collectors::packet_manager manager;
+    collectors::marker marker(&manager, nullptr);
+
+    timer tm;
+
+    gc_cell root_cell = allocators::memory_index::get_gc_cell(root);
+    root_cell.set_mark(true);
+    marker.add_root(root_cell);
+    marker.mark();
+
+    auto elapsed = tm.elapsed<std::chrono::microseconds>();
+
+    size_t marked_mem = 0;
+    for (byte* ptr: cells) {
+        gc_cell cell = allocators::memory_index::get_gc_cell(ptr);
+        if (!cell.get_mark()) {
+            cout << "Failed" << endl;
+        }
+        marked_mem += cell.cell_size();
+    }
+    return static_cast<double>(marked_mem) / elapsed;
+}
+
+template <typename Index>
+double LookupThroughput(const Index& index, const vector<byte*>& cells)
+{
+    timer tm;
+
+    size_t found = 0;
+    for (int i = 0; i < kIterations; ++i) {
+        for (byte* ptr: cells) {
+            found += index.get_descriptor(ptr).is_null() ? 0 : 1;
+        }
+    }
+
+    auto elapsed = tm.elapsed<std::chrono::microseconds>();
+    if (found != kIterations * cells.size()) {
+        cout << "Failed" << endl;
+    }
+    return static_cast<double>(found) / elapsed;
+}
+
+void LookupBenchmark(const vector<byte*>& cells)
+{
+    vector<byte*> pages;
+    for (byte* ptr: cells) {
+        byte* page = reinterpret_cast<byte*>(reinterpret_cast<uintptr_t>(ptr) & ~(PAGE_SIZE - 1));
+        if (pages.empty() || pages.back() != page) {
+            pages.push_back(page);
+        }
+    }
+    std::sort(pages.begin(), pages.end());
+    pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+    allocators::index_tree tree;
+    for (byte* page: pages) {
+        tree.index(page, PAGE_SIZE, allocators::memory_index::get_descriptor(page));
+    }
+    cout << "Index tree lookup " << LookupThroughput(tree, cells) << " Mlookups/s" << endl;
+
+    auto range = allocators::reserved_range_allocator::reserved_range();
+    if (!range.empty() && allocators::reserved_range_allocator::contains(pages.front())) {
+        allocators::page_table table;
+        table.init(range.begin(), range.size());
+        for (byte* page: pages) {
+            table.index(page, PAGE_SIZE, allocators::memory_index::get_descriptor(page));
+        }
+        cout << "Page table lookup " << LookupThroughput(table, cells) << " Mlookups/s" << endl;
+    }
+
+    for (byte* page: pages) {
+        tree.deindex(page, PAGE_SIZE);
+    }
+}
+
+// threads index interleaved pages, so they contend on the same levels,
+// and all levels are removed and created again on each round
+void ConcurrentIndexBenchmark()
+{
+    const size_t LEAF_SPAN = PAGE_SIZE * allocators::internals::splitter::LEVEL_SIZE;
+    const size_t PAGES_CNT = 4 * allocators::internals::splitter::LEVEL_SIZE / kIndexThreads;
+
+    // the tree is owned by the benchmark, so any page aligned memory can be indexed
+    byte* mem = reinterpret_cast<byte*>(64 * LEAF_SPAN);
+
+    allocators::index_tree tree;
+    auto routine = [&tree, mem] (size_t thread_num) {
+        size_t entry = 0;
+        auto descriptor = allocators::memory_descriptor::make_stack_descriptor(reinterpret_cast<byte*>(&entry));
+        for (size_t round = 0; round < kIndexRounds; ++round) {
+            for (size_t i = 0; i < PAGES_CNT; ++i) {
+                tree.index(mem + (i * kIndexThreads + thread_num) * PAGE_SIZE, PAGE_SIZE, descriptor);
+            }
+            for (size_t i = 0; i < PAGES_CNT; ++i) {
+                tree.deindex(mem + (i * kIndexThreads + thread_num) * PAGE_SIZE, PAGE_SIZE);
+            }
+        }
+    };
+
+    timer tm;
+
+    vector<std::thread> threads;
+    for (size_t i = 0; i < kIndexThreads; ++i) {
+        threads.emplace_back(routine, i);
+    }
+    for (auto& thrd: threads) {
+        thrd.join();
+    }
+
+    auto elapsed = tm.elapsed<std::chrono::microseconds>();
+
+    // the only mutator is blocked here and the serial collector is not running,
+    // so no thread accesses the memory index while the removed levels are recycled
+    allocators::index_tree::reclaim();
+
+    size_t ops = 2 * kIndexThreads * kIndexRounds * PAGES_CNT;
+    cout << "Index tree index/deindex " << static_cast<size_t>(static_cast<double>(ops) / elapsed) << " Mops/s" << endl;
+}
+
+// the way gc_box traced objects before the pointers mask
+template <typename Visitor>
+void TraceOffsets(byte* cell_start, Visitor&& visitor)
+{
+    const gc_type_meta* type_meta = allocators::gc_box::get_type_meta(cell_start);
+    byte*  obj      = allocators::gc_box::get_obj_start(cell_start);
+    size_t obj_cnt  = allocators::gc_box::get_obj_count(cell_start);
+    size_t obj_size = type_meta->type_size();
+
+    auto   offsets     = type_meta->offsets();
+    size_t offsets_cnt = offsets.size();
+    for (size_t i = 0; i < obj_cnt; i++) {
+        for (size_t j = 0; j < offsets_cnt; j++) {
+            visitor(reinterpret_cast<gc_handle*>(obj + offsets[j]));
+        }
+        obj += obj_size;
+    }
+}
+
+void TraceBenchmark()
+{
+    gc_ptr<Node[]> array = gc_new<Node[]>(kArraySize);
+    gc_pin<Node[]> pin = array.pin();
+    byte* cell_start = allocators::memory_index::get_gc_cell(reinterpret_cast<byte*>(pin.get())).cell_start();
+
+    size_t traced = 0;
+    auto visitor = [&traced] (gc_handle* handle) {
+        traced += gc_handle_access::get<std::memory_order_relaxed>(*handle) ? 0 : 1;
+    };
+
+    timer offsets_tm;
+    for (int i = 0; i < kIterations; ++i) {
+        TraceOffsets(cell_start, visitor);
+    }
+    auto offsets_elapsed = offsets_tm.elapsed<std::chrono::microseconds>();
+
+    timer mask_tm;
+    for (int i = 0; i < kIterations; ++i) {
+        allocators::gc_box::trace(cell_start, visitor);
+    }
+    auto mask_elapsed = mask_tm.elapsed<std::chrono::microseconds>();
+
+    if (traced != 2 * 2 * kIterations * kArraySize) {
+        cout << "Failed" << endl;
+    }
+    double slots = 2.0 * kIterations * kArraySize;
+    cout << "Offsets trace " << static_cast<size_t>(slots / offsets_elapsed) << " Mslots/s" << endl;
+    cout << "Pointers mask trace " << static_cast<size_t>(slots / mask_elapsed) << " Mslots/s" << endl;
+}
+
+int main(int argc, const char* argv[])
+{
+    register_main_thread();
+
+    bool reserved = !allocators::reserved_range_allocator::reserved_range().empty();
+    cout << "Memory index: " << (reserved ? "page table" : "index tree") << endl;
+
+    cout << "Creating binary tree of depth " << kTreeDepth << endl;
+    gc_ptr<Node> root = MakeTree(kTreeDepth);
+
+    vector<byte*> cells;
+    CollectCells(root, cells);
+
+    double throughput = 0;
+    for (int i = 0; i < kIterations; ++i) {
+        throughput += MarkThroughput(cells.front(), cells);
+    }
+    cout << "Mark throughput " << static_cast<size_t>(throughput / kIterations) << " MB/s" << endl;
+
+    LookupBenchmark(cells);
+
+    ConcurrentIndexBenchmark();
+
+    TraceBenchmark();
+
+    cout.flush();
+    return 0;
+}
@@ -32,6 +32,12 @@
     using namespace allocgc::cms;
 #endif
 
+#ifdef PRECISE_GC_TLH
+#include "liballocgc/liballocgc.hpp"
+    using namespace allocgc;
+    using namespace allocgc::tlh;
+#endif
+
 #include "../../common/macro.hpp"
 #include "../../common/timer.hpp"
 
@@ -74,7 +80,7 @@ ptr_t(Node) advance(ptr_t(Node) node, size_t n)
     return node;
 }
 
-#if !(defined(PRECISE_GC_SERIAL) || defined(PRECISE_GC_CMS))
+#if !(defined(PRECISE_GC_SERIAL) || defined(PRECISE_GC_CMS) || defined(PRECISE_GC_TLH))
     template <typename Function, typename... Args>
     std::thread create_thread(Function&& f, Args&&... args)
     {
@@ -284,7 +290,7 @@ int main(int argc, const char* argv[])
         }
     }
 
-    #if defined(PRECISE_GC_SERIAL) || defined(PRECISE_GC_CMS)
+    #if defined(PRECISE_GC_SERIAL) || defined(PRECISE_GC_CMS) || defined(PRECISE_GC_TLH)
         register_main_thread();
         set_threads_available(1);
 //        enable_logging(gc_loglevel::DEBUG);
@@ -296,10 +302,16 @@ int main(int argc, const char* argv[])
         }
     #endif
 
-    List input_lists[threads_cnt - 1];
-    List output_lists[threads_cnt - 1];
+    #ifdef PRECISE_GC_TLH
+        // lists are shared by the threads, thus they should not lie on the stack of the main thread
+        std::vector<List> input_lists(threads_cnt - 1);
+        std::vector<List> output_lists(threads_cnt - 1);
+    #else
+        List input_lists[threads_cnt - 1];
+        List output_lists[threads_cnt - 1];
+    #endif
 
-    init(input_lists, output_lists);
+    init(&input_lists[0], &output_lists[0]);
     auto guard = allocgc::details::utils::make_scope_guard([&done_flag, &tasks_ready_barrier] {
         done_flag = true;
         tasks_ready_barrier.wait();
@@ -314,18 +326,22 @@ int main(int argc, const char* argv[])
         if ((i+1) % 32 == 0) {
             std::cout << (i+1) * 100 / lists_count << "%" << std::endl;
         }
-        routine(input_lists, output_lists);
+        routine(&input_lists[0], &output_lists[0]);
     }
 
     std::cout << "Completed in " << tm.elapsed<std::chrono::milliseconds>() << " ms" << std::endl;
     #if defined(BDW_GC)
         std::cout << "Completed " << GC_get_gc_no() << " collections" << std::endl;
         std::cout << "Heap size is " << GC_get_heap_size() << std::endl;
-    #elif defined(PRECISE_GC_SERIAL) || defined(PRECISE_GC_CMS)
+    #elif defined(PRECISE_GC_SERIAL) || defined(PRECISE_GC_CMS) || defined(PRECISE_GC_TLH)
         gc_stat stat = stats();
         std::cout << "Completed " << stat.gc_count << " collections" << std::endl;
         std::cout << "Time spent in gc " << std::chrono::duration_cast<std::chrono::milliseconds>(stat.gc_time).count() << " ms" << std::endl;
         std::cout << "Average pause time " << std::chrono::duration_cast<std::chrono::microseconds>(stat.gc_time / stat.gc_count).count() << " us" << std::endl;
+        #ifdef PRECISE_GC_TLH
+            std::cout << "Local collections " << stat.minor_pauses.count
+                      << ", global collections " << stat.major_pauses.count << std::endl;
+        #endif
     #endif
 
     done_flag = true;
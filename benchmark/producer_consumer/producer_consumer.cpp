@@ -11,10 +11,26 @@
     #include <gc/gc.h>
 #endif
 
-#ifdef PRECISE_GC
+#ifdef PRECISE_GC_SERIAL
+    #include <liballocgc/liballocgc.hpp>
+    using namespace allocgc;
+    using namespace allocgc::serial;
+#endif
+
+#ifdef PRECISE_GC_CMS
+    #include <liballocgc/liballocgc.hpp>
+    using namespace allocgc;
+    using namespace allocgc::cms;
+#endif
+
+#ifdef PRECISE_GC_SATB
     #include <liballocgc/liballocgc.hpp>
-    #include <liballocgc/details/threads/managed_thread.hpp>
-using namespace precisegc;
+    using namespace allocgc;
+    using namespace allocgc::satb;
+#endif
+
+#if defined(PRECISE_GC_SERIAL) || defined(PRECISE_GC_CMS) || defined(PRECISE_GC_SATB)
+    #define PRECISE_GC
 #endif
 
 #include <liballocgc/details/utils/scoped_thread.hpp>
@@ -24,10 +40,10 @@ using namespace precisegc;
 #include "../../common/timer.hpp"
 
 template <typename Function, typename... Args>
-std::thread create_thread(Function&& f, Args&&... args)
+std::thread launch_thread(Function&& f, Args&&... args)
 {
 #ifdef PRECISE_GC
-    return gc_thread::create(std::forward<Function>(f), std::forward<Args>(args)...);
+    return create_thread(std::forward<Function>(f), std::forward<Args>(args)...);
 #else
     return std::thread(std::forward<Function>(f), std::forward<Args>(args)...);
 #endif
@@ -91,7 +107,7 @@ void producer_routine(pc_queue* queue)
     for (size_t n = 0; n < TOTAL_WORK; ++n) {
         ptr_t(work_packet) packet = new_(work_packet);
         pin_t(work_packet) pin_packet = pin(packet);
-        memset(pin_packet->m_data, 0, PACKET_SIZE);
+        memset(pin_packet->m_data, 0, PACKET_SIZE * sizeof(int));
 //        for (size_t i = 0; i < PACKET_SIZE; ++i) {
 //            pin_packet->m_data[i] = rand();
 //        }
@@ -125,26 +141,20 @@ void consumer_routine(pc_queue* queue)
 int main(int argc, const char* argv[])
 {
     bool incremental_flag = false;
-    bool compacting_flag = false;
     for (int i = 1; i < argc; ++i) {
         auto arg = std::string(argv[i]);
         if (arg == "--incremental") {
             incremental_flag = true;
-        } else if (arg == "--compacting") {
-            compacting_flag = true;
         }
     }
 
 #if defined(PRECISE_GC)
-    gc_init_options ops;
-//    ops.heapsize = 4 * 1024 * 1024;      // 4 Mb
-    ops.threads_available = 1;
-    ops.algo = incremental_flag ? gc_algo::INCREMENTAL : gc_algo::SERIAL;
-    ops.initiation = gc_initiation::SPACE_BASED;
-    ops.compacting = compacting_flag ? gc_compacting::ENABLED : gc_compacting::DISABLED;
-    ops.loglevel = gc_loglevel::SILENT;
-    ops.print_stat = false;
-    gc_init(ops);
+    register_main_thread();
+    if (incremental_flag) {
+        // without spare cores cms and satb do the marking in slices on the allocation path
+        set_threads_available(1);
+    }
+//    set_heap_limit(4 * 1024 * 1024);
 #elif defined(BDW_GC)
     GC_INIT();
         GC_allow_register_threads();
@@ -157,10 +167,10 @@ int main(int argc, const char* argv[])
     std::cout << "Size of queue " << QUEUE_SIZE * sizeof(work_packet) << " b" << std::endl;
     std::cout << "Total memory usage " << TOTAL_WORK * sizeof(work_packet) << " b" << std::endl;
 
-    typedef precisegc::details::utils::scoped_thread thread_t;
+    typedef allocgc::details::utils::scoped_thread thread_t;
     pc_queue queue;
-    thread_t consumer_thread = create_thread(consumer_routine, &queue);
-    thread_t producer_thread = create_thread(producer_routine, &queue);
+    thread_t consumer_thread = launch_thread(consumer_routine, &queue);
+    thread_t producer_thread = launch_thread(producer_routine, &queue);
 
     timer tm;
     consumer_thread.join();
@@ -170,7 +180,7 @@ int main(int argc, const char* argv[])
     std::cout << "Completed " << GC_get_gc_no() << " collections" << std::endl;
         std::cout << "Heap size is " << GC_get_heap_size() << std::endl;
 #elif defined(PRECISE_GC)
-    gc_stat stat = gc_stats();
+    gc_stat stat = stats();
     std::cout << "Completed " << stat.gc_count << " collections" << std::endl;
     std::cout << "Time spent in gc " << std::chrono::duration_cast<std::chrono::milliseconds>(stat.gc_time).count() << " ms" << std::endl;
     std::cout << "Average pause time " << std::chrono::duration_cast<std::chrono::microseconds>(stat.gc_time / stat.gc_count).count() << " us" << std::endl;
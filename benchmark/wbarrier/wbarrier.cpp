@@ -0,0 +1,111 @@
+// Write barrier microbenchmark.
+//
+// Measures throughput of pointer stores into the fields of heap objects
+// for raw pointers and for gc_ptr of the serial and the concurrent collectors
+// (the latter when no marking is running, i.e. on the fast path of the barrier).
+//
+// Usage: wbarrier [serial|cms]
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include <liballocgc/liballocgc.hpp>
+
+#include "../../common/timer.hpp"
+
+using namespace allocgc;
+
+using namespace std;
+
+static const size_t kNodesCount = 1024;
+static const size_t kStoresCount = 1 << 27;
+
+struct RawNode
+{
+    RawNode* next;
+};
+
+namespace serial_nodes {
+struct Node
+{
+    serial::gc_ptr<Node> next;
+};
+}
+
+namespace cms_nodes {
+struct Node
+{
+    cms::gc_ptr<Node> next;
+};
+}
+
+ALLOCGC_DECLARE_TYPE_LAYOUT(serial_nodes::Node, offsetof(serial_nodes::Node, next))
+ALLOCGC_DECLARE_TYPE_LAYOUT(cms_nodes::Node, offsetof(cms_nodes::Node, next))
+
+// returns millions of stores per second
+double Throughput(size_t stores_count, long long elapsed_us)
+{
+    return elapsed_us > 0 ? (double) stores_count / elapsed_us : 0;
+}
+
+double RawStores()
+{
+    vector<RawNode> nodes(kNodesCount);
+
+    timer tm;
+    for (size_t i = 0; i < kStoresCount; ++i) {
+        RawNode& node = nodes[i % kNodesCount];
+        // prevent the compiler from folding the stores
+        asm volatile("" : : "r"(&node) : "memory");
+        node.next = &nodes[(i + 1) % kNodesCount];
+    }
+    return Throughput(kStoresCount, tm.elapsed<std::chrono::microseconds>());
+}
+
+template <typename Node, template <typename> class Ptr, template <typename> class Pin, typename New>
+double GcStores(New gc_new_node)
+{
+    vector<Ptr<Node>> nodes;
+    vector<Pin<Node>> pins;
+    nodes.reserve(kNodesCount);
+    pins.reserve(kNodesCount);
+    for (size_t i = 0; i < kNodesCount; ++i) {
+        nodes.push_back(gc_new_node());
+        pins.push_back(nodes.back().pin());
+    }
+
+    timer tm;
+    for (size_t i = 0; i < kStoresCount; ++i) {
+        Node* node = pins[i % kNodesCount].get();
+        asm volatile("" : : "r"(node) : "memory");
+        node->next = nodes[(i + 1) % kNodesCount];
+    }
+    return Throughput(kStoresCount, tm.elapsed<std::chrono::microseconds>());
+}
+
+int main(int argc, const char* argv[])
+{
+    // collectors share the memory index, so only one of them can be used in the process
+    string gc_name = argc > 1 ? argv[1] : "cms";
+
+    cout << "Pointer stores throughput (millions of stores per second)" << endl;
+    cout << "raw pointer: " << RawStores() << endl;
+    if (gc_name == "serial") {
+        serial::register_main_thread();
+        cout << "serial gc_ptr: "
+             << GcStores<serial_nodes::Node, serial::gc_ptr, serial::gc_pin>([] { return serial::gc_new<serial_nodes::Node>(); })
+             << endl;
+    } else if (gc_name == "cms") {
+        cms::register_main_thread();
+        cout << "cms gc_ptr: "
+             << GcStores<cms_nodes::Node, cms::gc_ptr, cms::gc_pin>([] { return cms::gc_new<cms_nodes::Node>(); })
+             << endl;
+    } else {
+        cout << "Usage: wbarrier [serial|cms]" << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -74,6 +74,90 @@
     #define const_array_pointer_cast_(T, ptr) allocgc::pointers::const_pointer_cast<T[]>(ptr)
     #define reinterpret_array_pointer_cast_(T, ptr) allocgc::pointers::reinterpret_pointer_cast<T[]>(ptr)
 
+#elif defined(PRECISE_GC_SATB)
+    #define ptr_t(T) allocgc::satb::gc_ptr<T>
+    #define ptr_in(T) const allocgc::satb::gc_ptr<T>&
+    #define ref_t(T) allocgc::satb::gc_ref<T>
+    #define pin_t(T) allocgc::satb::gc_pin<T>
+    #define pin(ptr) ptr.pin()
+
+    #define raw_ptr(pin_ptr) pin_ptr.get()
+
+    #define ptr_array_t(T) allocgc::satb::gc_ptr<T[]>
+    #define pin_array_t(T) allocgc::satb::gc_pin<T[]>
+
+    #define new_(T) allocgc::satb::gc_new<T>()
+    #define new_args_(T, ...) allocgc::satb::gc_new<T>(__VA_ARGS__)
+    #define new_array_(T, size) allocgc::satb::gc_new<T[]>(size)
+
+    #define delete_(ptr)
+    #define set_null(ptr) ptr.reset()
+    #define null_ptr(T) allocgc::satb::gc_ptr<T>()
+
+    #define const_pointer_cast_(T, ptr) allocgc::pointers::const_pointer_cast<T>(ptr)
+    #define static_pointer_cast_(T, ptr) allocgc::pointers::static_pointer_cast<T>(ptr)
+    #define dynamic_pointer_cast_(T, ptr) allocgc::pointers::dynamic_pointer_cast<T>(ptr)
+    #define reinterpret_pointer_cast_(T, ptr) allocgc::pointers::reinterpret_pointer_cast<T>(ptr)
+
+    #define const_array_pointer_cast_(T, ptr) allocgc::pointers::const_pointer_cast<T[]>(ptr)
+    #define reinterpret_array_pointer_cast_(T, ptr) allocgc::pointers::reinterpret_pointer_cast<T[]>(ptr)
+
+#elif defined(PRECISE_GC_GEN)
+    #define ptr_t(T) allocgc::gen::gc_ptr<T>
+    #define ptr_in(T) const allocgc::gen::gc_ptr<T>&
+    #define ref_t(T) allocgc::gen::gc_ref<T>
+    #define pin_t(T) allocgc::gen::gc_pin<T>
+    #define pin(ptr) ptr.pin()
+
+    #define raw_ptr(pin_ptr) pin_ptr.get()
+
+    #define ptr_array_t(T) allocgc::gen::gc_ptr<T[]>
+    #define pin_array_t(T) allocgc::gen::gc_pin<T[]>
+
+    #define new_(T) allocgc::gen::gc_new<T>()
+    #define new_args_(T, ...) allocgc::gen::gc_new<T>(__VA_ARGS__)
+    #define new_array_(T, size) allocgc::gen::gc_new<T[]>(size)
+
+    #define delete_(ptr)
+    #define set_null(ptr) ptr.reset()
+    #define null_ptr(T) allocgc::gen::gc_ptr<T>()
+
+    #define const_pointer_cast_(T, ptr) allocgc::pointers::const_pointer_cast<T>(ptr)
+    #define static_pointer_cast_(T, ptr) allocgc::pointers::static_pointer_cast<T>(ptr)
+    #define dynamic_pointer_cast_(T, ptr) allocgc::pointers::dynamic_pointer_cast<T>(ptr)
+    #define reinterpret_pointer_cast_(T, ptr) allocgc::pointers::reinterpret_pointer_cast<T>(ptr)
+
+    #define const_array_pointer_cast_(T, ptr) allocgc::pointers::const_pointer_cast<T[]>(ptr)
+    #define reinterpret_array_pointer_cast_(T, ptr) allocgc::pointers::reinterpret_pointer_cast<T[]>(ptr)
+
+#elif defined(PRECISE_GC_TLH)
+    #define ptr_t(T) allocgc::tlh::gc_ptr<T>
+    #define ptr_in(T) const allocgc::tlh::gc_ptr<T>&
+    #define ref_t(T) allocgc::tlh::gc_ref<T>
+    #define pin_t(T) allocgc::tlh::gc_pin<T>
+    #define pin(ptr) ptr.pin()
+
+    #define raw_ptr(pin_ptr) pin_ptr.get()
+
+    #define ptr_array_t(T) allocgc::tlh::gc_ptr<T[]>
+    #define pin_array_t(T) allocgc::tlh::gc_pin<T[]>
+
+    #define new_(T) allocgc::tlh::gc_new<T>()
+    #define new_args_(T, ...) allocgc::tlh::gc_new<T>(__VA_ARGS__)
+    #define new_array_(T, size) allocgc::tlh::gc_new<T[]>(size)
+
+    #define delete_(ptr)
+    #define set_null(ptr) ptr.reset()
+    #define null_ptr(T) allocgc::tlh::gc_ptr<T>()
+
+    #define const_pointer_cast_(T, ptr) allocgc::pointers::const_pointer_cast<T>(ptr)
+    #define static_pointer_cast_(T, ptr) allocgc::pointers::static_pointer_cast<T>(ptr)
+    #define dynamic_pointer_cast_(T, ptr) allocgc::pointers::dynamic_pointer_cast<T>(ptr)
+    #define reinterpret_pointer_cast_(T, ptr) allocgc::pointers::reinterpret_pointer_cast<T>(ptr)
+
+    #define const_array_pointer_cast_(T, ptr) allocgc::pointers::const_pointer_cast<T[]>(ptr)
+    #define reinterpret_array_pointer_cast_(T, ptr) allocgc::pointers::reinterpret_pointer_cast<T[]>(ptr)
+
 #elif defined(BDW_GC)
     #define ptr_t(T) T*
     #define ptr_in(T) T*
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <liballocgc/details/allocators/card_table.hpp>
+
+using namespace allocgc;
+using namespace allocgc::details;
+using namespace allocgc::details::allocators;
+
+namespace {
+// table does not touch the memory of the range, thus any aligned address will do
+byte* const BASE = reinterpret_cast<byte*>(1024 * PAGE_SIZE);
+static const size_t SIZE = 16 * PAGE_SIZE;
+static const size_t CARD_SIZE = card_table::CARD_SIZE;
+}
+
+TEST(card_table_test, test_dirty)
+{
+    card_table cards;
+    cards.init(BASE, SIZE);
+    cards.cover(BASE, SIZE);
+
+    EXPECT_FALSE(cards.dirty(BASE - 1));
+    EXPECT_FALSE(cards.dirty(BASE + SIZE));
+
+    EXPECT_TRUE(cards.dirty(BASE + CARD_SIZE + 8));
+    EXPECT_TRUE(cards.is_dirty(BASE + CARD_SIZE));
+    EXPECT_FALSE(cards.is_dirty(BASE));
+    EXPECT_FALSE(cards.is_dirty(BASE + 2 * CARD_SIZE));
+}
+
+TEST(card_table_test, test_clean)
+{
+    card_table cards;
+    cards.init(BASE, SIZE);
+    cards.cover(BASE, SIZE);
+
+    byte* last = BASE + SIZE - 1;
+    cards.dirty(last);
+    cards.dirty(BASE + 3 * CARD_SIZE);
+    cards.dirty(BASE + 3 * CARD_SIZE + 16);
+
+    std::vector<byte*> scanned;
+    cards.clean([&scanned] (byte* begin, byte* end) {
+        EXPECT_EQ(CARD_SIZE, end - begin);
+        scanned.push_back(begin);
+    });
+    ASSERT_EQ(2, scanned.size());
+    EXPECT_EQ(BASE + 3 * CARD_SIZE, scanned[0]);
+    EXPECT_EQ(BASE + SIZE - CARD_SIZE, scanned[1]);
+
+    EXPECT_FALSE(cards.is_dirty(last));
+    size_t count = 0;
+    cards.clean([&count] (byte*, byte*) { ++count; });
+    EXPECT_EQ(0, count);
+}
+
+TEST(card_table_test, test_cover)
+{
+    card_table cards;
+    cards.init(BASE, SIZE);
+    cards.cover(BASE, PAGE_SIZE);
+
+    // cards of the memory which has not been covered yet are not scanned
+    cards.dirty(BASE + 8 * PAGE_SIZE);
+    cards.dirty(BASE);
+    size_t count = 0;
+    cards.clean([&count] (byte*, byte*) { ++count; });
+    EXPECT_EQ(1, count);
+
+    cards.cover(BASE + 8 * PAGE_SIZE, PAGE_SIZE);
+    cards.clear();
+    cards.clean([&count] (byte*, byte*) { ++count; });
+    EXPECT_EQ(1, count);
+}
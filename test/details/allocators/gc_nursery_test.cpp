@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <liballocgc/details/allocators/gc_nursery.hpp>
+
+using namespace allocgc;
+using namespace allocgc::details;
+using namespace allocgc::details::allocators;
+
+namespace {
+static const size_t SIZE = 4096;
+}
+
+TEST(gc_nursery_test, test_reserve)
+{
+    gc_nursery nursery(SIZE);
+
+    EXPECT_TRUE(nursery.reserve(SIZE / 2));
+    EXPECT_TRUE(nursery.reserve(SIZE / 2));
+    EXPECT_FALSE(nursery.reserve(1));
+    EXPECT_EQ(SIZE + 1, nursery.allocated());
+}
+
+TEST(gc_nursery_test, test_first_chunk)
+{
+    gc_nursery nursery(SIZE);
+
+    EXPECT_TRUE(nursery.reserve(2 * SIZE));
+    EXPECT_FALSE(nursery.reserve(SIZE));
+}
+
+TEST(gc_nursery_test, test_reset)
+{
+    gc_nursery nursery(SIZE);
+
+    EXPECT_TRUE(nursery.reserve(SIZE));
+    EXPECT_FALSE(nursery.reserve(SIZE));
+
+    nursery.reset();
+    EXPECT_EQ(0, nursery.allocated());
+    EXPECT_TRUE(nursery.reserve(SIZE));
+
+    nursery.reset();
+    nursery.set_size(2 * SIZE);
+    EXPECT_EQ(2 * SIZE, nursery.size());
+    EXPECT_TRUE(nursery.reserve(SIZE));
+    EXPECT_TRUE(nursery.reserve(SIZE));
+}
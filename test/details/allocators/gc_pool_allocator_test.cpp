@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include <liballocgc/details/allocators/gc_pool_allocator.hpp>
+#include <liballocgc/details/allocators/gc_nursery.hpp>
+#include <liballocgc/details/compacting/forwarding.hpp>
 #include <liballocgc/gc_type_meta.hpp>
 
 #include "utils.hpp"
@@ -84,3 +86,106 @@ TEST_F(gc_pool_allocator_test, test_collect)
 //    ASSERT_EQ(ALLOC_SIZE, stat.mem_copied);
     ASSERT_EQ(1, stat.pinned_cnt);
 }
+
+TEST_F(gc_pool_allocator_test, test_chunk_reuse)
+{
+    gc_alloc::response rsp1 = alloc.allocate(rqst, ALLOC_SIZE);
+    commit(rsp1);
+
+    compacting::forwarding frwd;
+    gc_collect_stat stat = alloc.collect(frwd);
+
+    ASSERT_EQ(CHUNK_SIZE, stat.mem_freed);
+    ASSERT_TRUE(alloc.empty());
+
+    gc_alloc::response rsp2 = alloc.allocate(rqst, ALLOC_SIZE);
+    commit(rsp2);
+
+    ASSERT_EQ(rsp1.cell_start(), rsp2.cell_start());
+    ASSERT_EQ(CHUNK_SIZE, alloc.stats().mem_used);
+}
+
+TEST_F(gc_pool_allocator_test, test_evacuate)
+{
+    gc_nursery nursery;
+    gc_pool_allocator young;
+    young.set_core_allocator(&core_alloc);
+    young.set_nursery(&nursery);
+    young.set_young(true);
+
+    gc_alloc::response rsp1 = young.allocate(rqst, ALLOC_SIZE);
+    commit(rsp1);
+    set_mark(rsp1, true);
+    set_pin(rsp1, true);
+
+    gc_alloc::response rsp2 = young.allocate(rqst, ALLOC_SIZE);
+    commit(rsp2);
+
+    gc_alloc::response rsp3 = young.allocate(rqst, ALLOC_SIZE);
+    commit(rsp3);
+    set_mark(rsp3, true);
+
+    EXPECT_EQ(CHUNK_SIZE, nursery.allocated());
+    EXPECT_TRUE(gc_pool_descriptor::is_young_ptr(rsp1.cell_start()));
+
+    compacting::forwarding frwd;
+    gc_collect_stat stat = young.evacuate(alloc, frwd);
+    ASSERT_EQ(ALLOC_SIZE, stat.mem_moved);
+
+    gc_handle handle;
+    gc_handle_access::set<std::memory_order_relaxed>(handle, rsp3.obj_start());
+    frwd.forward(&handle);
+    byte* promoted = gc_handle_access::get<std::memory_order_relaxed>(handle);
+    ASSERT_NE(rsp3.obj_start(), promoted);
+    ASSERT_FALSE(gc_pool_descriptor::is_young_ptr(promoted));
+
+    std::vector<gc_handle*> young_slots;
+    young.fix_survivors(frwd, young_slots);
+    alloc.fix_survivors(frwd, young_slots);
+    ASSERT_TRUE(young_slots.empty());
+
+    stat = young.release_evacuated();
+    ASSERT_EQ(ALLOC_SIZE, stat.mem_freed);
+    ASSERT_EQ(1, stat.pinned_cnt);
+    ASSERT_NE(gc_lifetime_tag::FREE, get_lifetime_tag(rsp1));
+    ASSERT_FALSE(young.empty());
+}
+
+TEST_F(gc_pool_allocator_test, test_sweep_fresh)
+{
+    gc_alloc::response rsp1 = alloc.allocate(rqst, ALLOC_SIZE);
+    commit(rsp1);
+    set_mark(rsp1, true);
+    set_pin(rsp1, true);
+
+    gc_alloc::response rsp2 = alloc.allocate(rqst, ALLOC_SIZE);
+    commit(rsp2);
+
+    gc_collect_stat stat = alloc.sweep_fresh();
+    ASSERT_EQ(ALLOC_SIZE, stat.mem_freed);
+    ASSERT_EQ(1, stat.pinned_cnt);
+    ASSERT_TRUE(get_mark(rsp1));
+    ASSERT_FALSE(get_pin(rsp1));
+    ASSERT_EQ(gc_lifetime_tag::FREE, get_lifetime_tag(rsp2));
+
+    stat = alloc.sweep_fresh();
+    ASSERT_EQ(0, stat.mem_freed);
+    ASSERT_TRUE(get_mark(rsp1));
+}
+
+TEST_F(gc_pool_allocator_test, test_chunk_cache_flush)
+{
+    gc_alloc::response rsp = alloc.allocate(rqst, ALLOC_SIZE);
+    commit(rsp);
+    size_t heap_size = core_alloc.heap_size();
+
+    compacting::forwarding frwd;
+    alloc.collect(frwd);
+
+    ASSERT_TRUE(alloc.empty());
+    ASSERT_EQ(heap_size, core_alloc.heap_size());
+
+    alloc.collect(frwd);
+
+    ASSERT_EQ(0, core_alloc.heap_size());
+}
@@ -1,12 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <memory>
+#include <thread>
+#include <vector>
 #include <utility>
 
 #include <liballocgc/details/allocators/memory_index.hpp>
 #include <liballocgc/details/allocators/gc_pool_descriptor.hpp>
 #include <liballocgc/details/allocators/gc_core_allocator.hpp>
-#include <liballocgc/details/allocators/debug_layer.hpp>
 #include <liballocgc/details/allocators/gc_box.hpp>
 
 #include "rand_util.h"
@@ -19,26 +21,25 @@ namespace {
 const size_t CELL_SIZE  = 64;
 const size_t CELL_COUNT = 64;
 const size_t CHUNK_SIZE = gc_pool_descriptor::chunk_size(CELL_COUNT * CELL_SIZE);
+const size_t NUMA_NODE  = 0;
 }
 
 class managed_pool_chunk_test : public ::testing::Test
 {
 public:
-    typedef debug_layer<gc_core_allocator> allocator_t;
-
     managed_pool_chunk_test()
-        : m_chunk(m_alloc.allocate(CHUNK_SIZE), CELL_COUNT * CELL_SIZE, CELL_SIZE)
+        : m_chunk(m_alloc.allocate(CHUNK_SIZE, NUMA_NODE), CELL_COUNT * CELL_SIZE, CELL_SIZE, NUMA_NODE)
         , m_rand(0, CELL_COUNT)
     {}
 
     ~managed_pool_chunk_test()
     {
         if (m_chunk.memory()) {
-            m_alloc.deallocate(m_chunk.memory(), CHUNK_SIZE);
+            m_alloc.deallocate(m_chunk.memory(), CHUNK_SIZE, m_chunk.numa_node());
         }
     }
 
-    allocator_t m_alloc;
+    gc_core_allocator m_alloc;
     gc_pool_descriptor m_chunk;
     uniform_rand_generator<size_t> m_rand;
 };
@@ -106,6 +107,36 @@ TEST_F(managed_pool_chunk_test, test_set_mark)
     ASSERT_EQ(descr->get_mark(ptr), true);
 }
 
+TEST_F(managed_pool_chunk_test, test_try_mark)
+{
+    static const size_t THREADS_CNT = 4;
+
+    gc_memory_descriptor* descr = m_chunk.descriptor();
+    byte* mem = m_chunk.memory();
+    size_t mem_size = m_chunk.size();
+
+    // each cell should be marked exactly by one thread
+    std::atomic<size_t> marked_cnt(0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < THREADS_CNT; ++i) {
+        threads.emplace_back([descr, mem, mem_size, &marked_cnt] {
+            for (byte* ptr = mem; ptr < mem + mem_size; ptr += CELL_SIZE) {
+                if (descr->try_mark(ptr)) {
+                    marked_cnt.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(mem_size / CELL_SIZE, marked_cnt.load());
+    for (byte* ptr = mem; ptr < mem + mem_size; ptr += CELL_SIZE) {
+        ASSERT_TRUE(descr->get_mark(ptr));
+    }
+}
+
 TEST_F(managed_pool_chunk_test, test_set_pin)
 {
     gc_memory_descriptor* descr = m_chunk.descriptor();
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <liballocgc/details/collectors/gc_pacer.hpp>
+
+using namespace allocgc;
+using namespace allocgc::details;
+using namespace allocgc::details::collectors;
+
+namespace {
+static const size_t MB = 1024 * 1024;
+static const size_t HEAP_LIMIT = 100 * MB;
+static const size_t HEAP_START = 50 * MB;
+static const size_t THREADS_MAX = 4;
+}
+
+TEST(gc_pacer_test, test_default)
+{
+    gc_pacer pacer;
+
+    EXPECT_EQ(gc_pacer::DEFAULT_TRIGGER, pacer.mark_trigger(THREADS_MAX));
+    EXPECT_EQ(THREADS_MAX, pacer.marker_threads(THREADS_MAX));
+}
+
+TEST(gc_pacer_test, test_concurrent_done)
+{
+    gc_pacer pacer;
+    pacer.start_cycle(HEAP_START, 0, 1);
+    // marking has been finished after the heap has grown by 10% of the limit
+    pacer.concurrent_done(HEAP_START + 10 * MB);
+    pacer.finish_cycle(HEAP_LIMIT, HEAP_LIMIT, 10 * MB, 10 * MB);
+
+    EXPECT_EQ(1, pacer.marker_threads(THREADS_MAX));
+    EXPECT_NEAR(1.0 - 1.2 * 0.1, pacer.mark_trigger(1), 1e-9);
+    EXPECT_EQ(gc_pacer::MAX_TRIGGER, pacer.mark_trigger(2));
+}
+
+TEST(gc_pacer_test, test_concurrent_not_done)
+{
+    gc_pacer pacer;
+    pacer.start_cycle(HEAP_START, 0, 1);
+    // only quarter of live memory has been marked before the heap limit has been reached
+    pacer.finish_cycle(HEAP_LIMIT, HEAP_LIMIT, 10 * MB, 40 * MB);
+
+    EXPECT_EQ(gc_pacer::MIN_TRIGGER, pacer.mark_trigger(1));
+    EXPECT_EQ(THREADS_MAX, pacer.marker_threads(THREADS_MAX));
+    EXPECT_LT(pacer.mark_trigger(1), pacer.mark_trigger(THREADS_MAX));
+}
+
+TEST(gc_pacer_test, test_incremental)
+{
+    gc_pacer pacer;
+    pacer.start_cycle(HEAP_START, 0, 0);
+    pacer.concurrent_done(HEAP_START + 20 * MB);
+    pacer.finish_cycle(HEAP_LIMIT, HEAP_LIMIT, 10 * MB, 10 * MB);
+
+    EXPECT_NEAR(1.0 - 1.2 * 0.2, pacer.mark_trigger(0), 1e-9);
+    // estimate of incremental marking says nothing about marker threads
+    EXPECT_EQ(gc_pacer::DEFAULT_TRIGGER, pacer.mark_trigger(1));
+}
@@ -2,6 +2,9 @@
 
 #include <random>
 #include <limits>
+#include <atomic>
+#include <thread>
+#include <vector>
 #include <liballocgc/details/allocators/index_tree.hpp>
 
 #include "liballocgc/details/allocators/index_tree.hpp"
@@ -136,4 +139,82 @@ TEST_F(index_tree_test, test_remove_index)
 
     ASSERT_TRUE(m_tree.get_descriptor(mem1).is_null());
     ASSERT_EQ(pEntry2, m_tree.get_descriptor(mem2).to_stack_descriptor());
-}
\ No newline at end of file
+}
+
+TEST_F(index_tree_test, test_index_range)
+{
+    const size_t LEAF_SPAN = PAGE_SIZE * allocators::internals::splitter::LEVEL_SIZE;
+    const size_t PAGES_CNT = 10;
+
+    // range crosses boundary of the last level
+    byte* mem = (byte*) ((m_ptrs[0] / LEAF_SPAN) * LEAF_SPAN + LEAF_SPAN - 3 * PAGE_SIZE);
+    size_t entry = 0;
+    byte* pEntry = (byte*) &entry;
+    memory_descriptor descriptor = memory_descriptor::make_stack_descriptor(pEntry);
+    m_tree.index(mem, PAGES_CNT * PAGE_SIZE, descriptor);
+
+    for (size_t i = 0; i < PAGES_CNT; ++i) {
+        ASSERT_EQ(pEntry, m_tree.get_descriptor(mem + i * PAGE_SIZE).to_stack_descriptor());
+    }
+
+    m_tree.deindex(mem, 2 * PAGE_SIZE);
+
+    ASSERT_TRUE(m_tree.get_descriptor(mem).is_null());
+    ASSERT_TRUE(m_tree.get_descriptor(mem + PAGE_SIZE).is_null());
+    for (size_t i = 2; i < PAGES_CNT; ++i) {
+        ASSERT_EQ(pEntry, m_tree.get_descriptor(mem + i * PAGE_SIZE).to_stack_descriptor());
+    }
+
+    m_tree.deindex(mem + 2 * PAGE_SIZE, (PAGES_CNT - 2) * PAGE_SIZE);
+
+    for (size_t i = 0; i < PAGES_CNT; ++i) {
+        ASSERT_TRUE(m_tree.get_descriptor(mem + i * PAGE_SIZE).is_null());
+    }
+}
+
+// threads index interleaved pages, so they contend on the same levels,
+// and all levels are removed and created again on each round;
+// the throughput of the same scenario is measured by benchmark/mark
+TEST_F(index_tree_test, test_concurrent_index)
+{
+    const size_t THREADS_CNT = 4;
+    const size_t ROUNDS_CNT  = 16;
+    const size_t LEAF_SPAN   = PAGE_SIZE * allocators::internals::splitter::LEVEL_SIZE;
+    const size_t PAGES_CNT   = 4 * allocators::internals::splitter::LEVEL_SIZE / THREADS_CNT;
+
+    byte* mem = (byte*) ((m_ptrs[0] / LEAF_SPAN) * LEAF_SPAN);
+
+    std::atomic<bool> failed(false);
+    auto routine = [this, mem, &failed] (size_t thread_num) {
+        size_t entry = 0;
+        memory_descriptor descriptor = memory_descriptor::make_stack_descriptor((byte*) &entry);
+        for (size_t round = 0; round < ROUNDS_CNT; ++round) {
+            for (size_t i = 0; i < PAGES_CNT; ++i) {
+                m_tree.index(mem + (i * THREADS_CNT + thread_num) * PAGE_SIZE, PAGE_SIZE, descriptor);
+            }
+            for (size_t i = 0; i < PAGES_CNT; ++i) {
+                byte* page = mem + (i * THREADS_CNT + thread_num) * PAGE_SIZE;
+                if (m_tree.get_descriptor(page).to_stack_descriptor() != (byte*) &entry) {
+                    failed.store(true);
+                }
+                m_tree.deindex(page, PAGE_SIZE);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < THREADS_CNT; ++i) {
+        threads.emplace_back(routine, i);
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    // removed levels are not reclaimed here: index_tree::reclaim() recycles the levels of all the trees,
+    // including the memory index, so it is left to the pauses of the collector
+
+    ASSERT_FALSE(failed.load());
+    for (size_t i = 0; i < THREADS_CNT * PAGES_CNT; ++i) {
+        ASSERT_TRUE(m_tree.get_descriptor(mem + i * PAGE_SIZE).is_null());
+    }
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <limits>
 #include <vector>
 #include <queue>
 
@@ -232,4 +233,216 @@ TEST_F(marker_test, test_pins)
     print_tree(root);
     check_nodes_marked(root, 1, 1, TREE_DEPTH);
     check_nodes_pinned(root, 1, 1, TREE_DEPTH);
-}
\ No newline at end of file
+}
+
+/**
+ * The following test checks that roots split into partitions and scanned by several threads are marked
+ * along with all the nodes accessible from them
+ */
+TEST_F(marker_test, test_parallel_roots)
+{
+    const size_t LIVE_LEVEL = 3;
+    const size_t THREADS_CNT = 4;
+
+    mark_tree(root, 1, LIVE_LEVEL, root_set);
+
+    std::vector<marker::root_scanner> scanners;
+    for (gc_handle* root: root_set.roots) {
+        scanners.emplace_back([root] (const gc_trace_callback& cb) { cb(root); });
+    }
+    marker.trace_roots(scanners, THREADS_CNT);
+    marker.mark();
+
+    check_nodes_marked(root, 1, LIVE_LEVEL, TREE_DEPTH);
+    EXPECT_TRUE(packet_manager.is_no_input());
+}
+
+/**
+ * The following test checks that incremental marking by bounded slices marks all the nodes accessible from roots
+ */
+TEST_F(marker_test, test_mark_increment)
+{
+    const size_t LIVE_LEVEL = 2;
+    const size_t SLICE_BUDGET = 64;
+
+    mark_tree(root, 1, LIVE_LEVEL, root_set);
+    for (gc_handle* root: root_set.roots) {
+        byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(*root);
+        gc_cell cell = allocators::memory_index::get_gc_cell(ptr);
+        cell.set_mark(true);
+        marker.add_root(cell);
+    }
+
+    marker.concurrent_mark(0);
+    size_t slices_cnt = 0;
+    while (marker.mark_increment(SLICE_BUDGET)) {
+        ++slices_cnt;
+    }
+    EXPECT_GT(slices_cnt, 1);
+    EXPECT_TRUE(packet_manager.is_no_input());
+    marker.mark();
+
+    check_nodes_marked(root, 1, LIVE_LEVEL, TREE_DEPTH);
+}
+
+/**
+ * The following test checks that the final marking launched with helper threads
+ * marks all the nodes accessible from roots after the concurrent marking has been drained
+ */
+TEST_F(marker_test, test_mark_helpers)
+{
+    const size_t LIVE_LEVEL = 2;
+    const size_t THREADS_CNT = 4;
+
+    marker.concurrent_mark(0);
+    while (marker.mark_increment(std::numeric_limits<size_t>::max())) {}
+
+    mark_tree(root, 1, LIVE_LEVEL, root_set);
+    for (gc_handle* root: root_set.roots) {
+        byte* ptr = gc_handle_access::get<std::memory_order_relaxed>(*root);
+        gc_cell cell = allocators::memory_index::get_gc_cell(ptr);
+        cell.set_mark(true);
+        marker.add_root(cell);
+    }
+    marker.mark(THREADS_CNT);
+
+    check_nodes_marked(root, 1, LIVE_LEVEL, TREE_DEPTH);
+    EXPECT_TRUE(packet_manager.is_no_input());
+}
+
+/**
+ * The following test checks that with several marking workers each node is traced exactly once
+ */
+TEST(marker_parallel_test, test_trace_once)
+{
+    const size_t DEPTH = 12;
+    const size_t THREADS_CNT = 4;
+
+    gc_ptr<node> root = create_tree(DEPTH);
+    test_root_set root_set;
+    mark_tree(root, 1, 0, root_set);
+
+    size_t tree_mem = 0;
+    std::queue<gc_ptr<node>> q;
+    q.push(root);
+    while (!q.empty()) {
+        gc_pin<node> pin = q.front().pin();
+        q.pop();
+        tree_mem += allocators::memory_index::get_gc_cell((byte*) pin.get()).cell_size();
+        if (pin->m_left) {
+            q.push(pin->m_left);
+        }
+        if (pin->m_right) {
+            q.push(pin->m_right);
+        }
+    }
+
+    collectors::packet_manager manager;
+    collectors::marker marker(&manager, nullptr);
+    gc_pin<node> pin = root.pin();
+    gc_cell cell = allocators::memory_index::get_gc_cell((byte*) pin.get());
+    cell.set_mark(true);
+    marker.add_root(cell);
+    marker.concurrent_mark(THREADS_CNT);
+    marker.mark();
+
+    check_nodes_marked(root, 1, 1, DEPTH);
+    EXPECT_EQ(tree_mem, marker.marked_mem());
+}
+
+/**
+ * The following test checks that marking does not fail when all mark packets are in use,
+ * and that cells which did not fit into packets are traced during the heap rescan
+ *
+ *      *   *   *   ...  <--------- roots (more than fit into one packet)
+ *      |   |   |
+ *      *   *   *   ...
+ *      |   |   |
+ *      *   *   *   ...  <--------- reachable only through overflowed cells
+ */
+TEST(marker_overflow_test, test_overflow)
+{
+    const size_t CHAINS_COUNT = 2048;
+    const size_t CHAIN_LENGTH = 3;
+
+    std::vector<gc_ptr<node>> chains;
+    std::vector<gc_cell> cells;
+    for (size_t i = 0; i < CHAINS_COUNT; ++i) {
+        gc_ptr<node> head = create_gc_node();
+        gc_ptr<node> tail = head;
+        for (size_t j = 1; j < CHAIN_LENGTH; ++j) {
+            tail->m_left = create_gc_node();
+            tail = tail->m_left;
+        }
+        chains.push_back(head);
+    }
+    for (auto& head: chains) {
+        for (gc_ptr<node> it = head; it; it = it->m_left) {
+            gc_pin<node> pin = it.pin();
+            gc_cell cell = allocators::memory_index::get_gc_cell((byte*) pin.get());
+            cell.set_mark(false);
+            cells.push_back(cell);
+        }
+    }
+
+    size_t rescan_cnt = 0;
+    auto walker = [&cells, &rescan_cnt] (const gc_cell_callback& cb) {
+        ++rescan_cnt;
+        for (auto& cell: cells) {
+            if (cell.get_mark()) {
+                cb(cell);
+            }
+        }
+    };
+
+    // the only packet of the manager holds less cells than there are roots
+    collectors::packet_manager manager(1, 1);
+    collectors::marker marker(&manager, nullptr, walker);
+    for (auto& head: chains) {
+        gc_pin<node> pin = head.pin();
+        gc_cell cell = allocators::memory_index::get_gc_cell((byte*) pin.get());
+        cell.set_mark(true);
+        marker.add_root(cell);
+    }
+    marker.mark();
+
+    EXPECT_GT(rescan_cnt, 0);
+    for (auto& cell: cells) {
+        EXPECT_TRUE(cell.get_mark()) << "ptr=" << (void*) cell.get();
+    }
+}
+
+/**
+ * The following test checks that all objects pointed by the large array are marked
+ * when the array is split into chunks
+ */
+TEST(marker_array_test, test_large_array)
+{
+    const size_t ARRAY_SIZE = 10000;
+
+    gc_ptr<node[]> array = gc_new<node[]>(ARRAY_SIZE);
+    gc_pin<node[]> pin = array.pin();
+    node* nodes = pin.get();
+    for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+        nodes[i].m_left = create_gc_node();
+    }
+
+    gc_cell array_cell = allocators::memory_index::get_gc_cell((byte*) pin.get());
+    ASSERT_GT(array_cell.cell_size(), 2 * 16 * 1024);
+    for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+        gc_pin<node> child = nodes[i].m_left.pin();
+        allocators::memory_index::get_gc_cell((byte*) child.get()).set_mark(false);
+    }
+
+    collectors::packet_manager manager;
+    collectors::marker marker(&manager, nullptr);
+    array_cell.set_mark(true);
+    marker.add_root(array_cell);
+    marker.mark();
+
+    for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+        gc_pin<node> child = nodes[i].m_left.pin();
+        EXPECT_TRUE(allocators::memory_index::get_gc_cell((byte*) child.get()).get_mark()) << "i=" << i;
+    }
+    EXPECT_TRUE(manager.is_no_input());
+}
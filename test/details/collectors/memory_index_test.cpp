@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 
 #include <liballocgc/details/allocators/gc_core_allocator.hpp>
+#include <liballocgc/details/allocators/gc_pool_descriptor.hpp>
 #include <liballocgc/details/allocators/memory_index.hpp>
+#include <liballocgc/details/allocators/reserved_range_allocator.hpp>
+#include <liballocgc/details/allocators/sys_allocator.hpp>
 #include <liballocgc/details/utils/scope_guard.hpp>
 
 #include "memory_descriptor_mock.h"
@@ -15,9 +18,9 @@ TEST(memory_index_test, test_index)
     gc_core_allocator core_alloc;
 
     auto deleter = [&core_alloc] (byte* ptr) {
-        core_alloc.deallocate(ptr, PAGE_SIZE);
+        core_alloc.deallocate(ptr, PAGE_SIZE, 0);
     };
-    std::unique_ptr<byte, decltype(deleter)> memory(core_alloc.allocate(PAGE_SIZE), deleter);
+    std::unique_ptr<byte, decltype(deleter)> memory(core_alloc.allocate(PAGE_SIZE, 0), deleter);
 
     memory_descriptor_mock mock;
     allocators::memory_index::index_gc_heap_memory(memory.get(), PAGE_SIZE, &mock);
@@ -28,4 +31,102 @@ TEST(memory_index_test, test_index)
     gc_memory_descriptor* descr = allocators::memory_index::get_descriptor(memory.get()).to_gc_descriptor();
 
     ASSERT_EQ(&mock, descr);
-}
\ No newline at end of file
+}
+
+TEST(memory_index_test, test_reserved_range)
+{
+    gc_core_allocator core_alloc;
+
+    byte* heap_page = core_alloc.allocate(PAGE_SIZE, 0);
+    byte* sys_page  = sys_allocator::allocate(PAGE_SIZE);
+    auto guard = utils::make_scope_guard([&core_alloc, heap_page, sys_page] () {
+        core_alloc.deallocate(heap_page, PAGE_SIZE, 0);
+        sys_allocator::deallocate(sys_page, PAGE_SIZE);
+    });
+
+    auto range = reserved_range_allocator::reserved_range();
+    if (range.empty()) {
+        return;
+    }
+    ASSERT_TRUE(reserved_range_allocator::contains(heap_page));
+    ASSERT_FALSE(reserved_range_allocator::contains(sys_page));
+
+    memory_descriptor_mock heap_mock;
+    memory_descriptor_mock sys_mock;
+    allocators::memory_index::index_gc_heap_memory(heap_page, PAGE_SIZE, &heap_mock);
+    allocators::memory_index::index_gc_heap_memory(sys_page, PAGE_SIZE, &sys_mock);
+
+    ASSERT_EQ(&heap_mock, allocators::memory_index::get_descriptor(heap_page + PAGE_SIZE / 2).to_gc_descriptor());
+    ASSERT_EQ(&sys_mock, allocators::memory_index::get_descriptor(sys_page + PAGE_SIZE / 2).to_gc_descriptor());
+
+    allocators::memory_index::deindex(heap_page, PAGE_SIZE);
+    allocators::memory_index::deindex(sys_page, PAGE_SIZE);
+
+    ASSERT_TRUE(allocators::memory_index::get_descriptor(heap_page).is_null());
+    ASSERT_TRUE(allocators::memory_index::get_descriptor(sys_page).is_null());
+}
+
+TEST(memory_index_test, test_pool_cell_start)
+{
+    gc_core_allocator core_alloc;
+
+    auto deleter = [&core_alloc] (byte* ptr) {
+        core_alloc.deallocate(ptr, PAGE_SIZE, 0);
+    };
+    std::unique_ptr<byte, decltype(deleter)> memory(core_alloc.allocate(PAGE_SIZE, 0), deleter);
+
+    const size_t CELL_SIZE_LOG2 = 6;
+    const size_t CELL_SIZE = 1 << CELL_SIZE_LOG2;
+
+    memory_descriptor_mock mock;
+    allocators::memory_index::index_gc_pool_memory(memory.get(), PAGE_SIZE, &mock, CELL_SIZE_LOG2);
+    auto guard = utils::make_scope_guard([&memory] () {
+        allocators::memory_index::deindex(memory.get(), PAGE_SIZE);
+    });
+
+    memory_descriptor entry = allocators::memory_index::get_descriptor(memory.get());
+    ASSERT_TRUE(entry.is_gc_heap_descriptor());
+    ASSERT_TRUE(entry.is_gc_pool_descriptor());
+    ASSERT_EQ(&mock, entry.to_gc_descriptor());
+
+    byte* cell = memory.get() + 3 * CELL_SIZE;
+    gc_cell gcell = allocators::memory_index::get_gc_cell(cell + CELL_SIZE / 2);
+
+    ASSERT_EQ(cell, gcell.get());
+    ASSERT_EQ(&mock, gcell.descriptor());
+}
+
+TEST(memory_index_test, test_heap_mark_bitmap)
+{
+    gc_core_allocator core_alloc;
+
+    const size_t CELL_SIZE = 64;
+    const size_t CHUNK_SIZE = gc_pool_descriptor::chunk_size(CELL_SIZE);
+
+    auto deleter = [&core_alloc, CHUNK_SIZE] (byte* ptr) {
+        core_alloc.deallocate(ptr, CHUNK_SIZE, 0);
+    };
+    std::unique_ptr<byte, decltype(deleter)> memory(core_alloc.allocate(CHUNK_SIZE, 0), deleter);
+
+    if (!allocators::memory_index::heap_mark_bitmap().contains(memory.get())) {
+        return;
+    }
+
+    gc_pool_descriptor descr(memory.get(), CHUNK_SIZE, CELL_SIZE);
+    descr.unmark();
+    ASSERT_TRUE(descr.unused());
+
+    byte* cell = memory.get() + 3 * CELL_SIZE;
+    ASSERT_TRUE(descr.try_mark(cell));
+    ASSERT_FALSE(descr.try_mark(cell));
+    ASSERT_TRUE(descr.get_mark(cell));
+    ASSERT_TRUE(allocators::memory_index::heap_mark_bitmap().get(cell));
+
+    descr.set_mark(memory.get(), true);
+    ASSERT_EQ(2, descr.count_lived());
+    ASSERT_FALSE(descr.get_mark(memory.get() + CELL_SIZE));
+
+    descr.unmark();
+    ASSERT_TRUE(descr.unused());
+    ASSERT_FALSE(descr.get_mark(cell));
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include <liballocgc/details/collectors/packet_manager.hpp>
+
+using namespace allocgc;
+using namespace allocgc::details;
+using namespace allocgc::details::collectors;
+
+namespace {
+static const size_t NUMA_NODES_COUNT = 2;
+}
+
+TEST(packet_manager_test, test_numa_node_preference)
+{
+    packet_manager manager(NUMA_NODES_COUNT);
+
+    auto packet0 = manager.pop_output_packet(0);
+    ASSERT_TRUE((bool) packet0);
+    ASSERT_EQ(0, packet0->numa_node());
+    packet0->push(gc_cell());
+    manager.push_packet(std::move(packet0));
+
+    auto packet1 = manager.pop_output_packet(1);
+    ASSERT_TRUE((bool) packet1);
+    ASSERT_EQ(1, packet1->numa_node());
+    packet1->push(gc_cell());
+    manager.push_packet(std::move(packet1));
+
+    auto input1 = manager.pop_input_packet(1);
+    ASSERT_TRUE((bool) input1);
+    ASSERT_EQ(1, input1->numa_node());
+
+    // packet of another node is stolen only when there are no local packets
+    auto input2 = manager.pop_input_packet(1);
+    ASSERT_TRUE((bool) input2);
+    ASSERT_EQ(0, input2->numa_node());
+
+    ASSERT_FALSE((bool) manager.pop_input_packet(1));
+
+    input1->pop();
+    input2->pop();
+    manager.push_packet(std::move(input1));
+    manager.push_packet(std::move(input2));
+    ASSERT_TRUE(manager.is_no_input());
+}
+
+TEST(packet_manager_test, test_worker_deque)
+{
+    packet_manager manager(1);
+
+    size_t worker1 = manager.attach_worker();
+    size_t worker2 = manager.attach_worker();
+    ASSERT_NE(packet_manager::NO_WORKER, worker1);
+    ASSERT_NE(packet_manager::NO_WORKER, worker2);
+
+    auto packet = manager.pop_output_packet();
+    while (!packet->is_full()) {
+        packet->push(gc_cell());
+    }
+    mark_packet* ptr = packet.get();
+    manager.push_packet(std::move(packet), worker1);
+
+    // full packet is pushed to the worker's deque and can be stolen by other worker
+    auto stolen = manager.pop_input_packet(0, worker2);
+    ASSERT_EQ(ptr, stolen.get());
+    ASSERT_FALSE((bool) manager.pop_input_packet(0, worker1));
+
+    while (!stolen->is_empty()) {
+        stolen->pop();
+    }
+    manager.push_packet(std::move(stolen), worker2);
+
+    // marking is finished only when both workers are idle
+    bool terminated = false;
+    std::thread thread([&manager, &terminated] {
+        terminated = manager.try_terminate();
+    });
+    ASSERT_TRUE(manager.try_terminate());
+    thread.join();
+    ASSERT_TRUE(terminated);
+    ASSERT_TRUE(manager.is_no_input());
+
+    manager.detach_workers();
+}
+
+TEST(packet_manager_test, test_grow)
+{
+    const size_t MAX_PACKETS_COUNT = 1000;
+    packet_manager manager(1, MAX_PACKETS_COUNT);
+    ASSERT_LT(manager.packets_count(), MAX_PACKETS_COUNT);
+
+    std::vector<packet_manager::mark_packet_handle> packets;
+    for (size_t i = 0; i < MAX_PACKETS_COUNT; ++i) {
+        auto packet = manager.pop_output_packet();
+        ASSERT_TRUE((bool) packet);
+        packets.push_back(std::move(packet));
+    }
+    ASSERT_EQ(MAX_PACKETS_COUNT, manager.packets_count());
+
+    // the arena is exhausted
+    ASSERT_FALSE((bool) manager.pop_output_packet());
+
+    for (auto& packet: packets) {
+        manager.push_packet(std::move(packet));
+    }
+    ASSERT_TRUE(manager.is_no_input());
+    ASSERT_TRUE((bool) manager.pop_output_packet());
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <liballocgc/details/collectors/remset.hpp>
+
+using namespace allocgc;
+using namespace allocgc::details;
+using namespace allocgc::details::collectors;
+
+namespace {
+static const size_t THREADS_CNT = 4;
+static const size_t PTRS_CNT = 1000;
+
+byte* make_ptr(size_t thread, size_t i)
+{
+    return reinterpret_cast<byte*>((thread * PTRS_CNT + i + 1) * sizeof(void*));
+}
+
+std::vector<byte*> consume_all(remset& rset)
+{
+    std::vector<byte*> ptrs;
+    while (rset.consume([&ptrs] (byte* ptr) { ptrs.push_back(ptr); }) > 0) {}
+    std::sort(ptrs.begin(), ptrs.end());
+    return ptrs;
+}
+}
+
+TEST(remset_test, test_add)
+{
+    remset rset;
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS_CNT; ++t) {
+        threads.emplace_back([&rset, t] {
+            for (size_t i = 0; i < PTRS_CNT; ++i) {
+                rset.add(make_ptr(t, i));
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    rset.flush_buffers();
+
+    EXPECT_EQ(THREADS_CNT * PTRS_CNT, rset.size());
+    std::vector<byte*> ptrs = consume_all(rset);
+    ASSERT_EQ(THREADS_CNT * PTRS_CNT, ptrs.size());
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+        EXPECT_EQ(make_ptr(0, i), ptrs[i]);
+    }
+    EXPECT_TRUE(rset.empty());
+}
+
+TEST(remset_test, test_chunks_reuse)
+{
+    // two chunks are enough, since consumed chunks are returned back
+    remset rset(2);
+
+    size_t consumed = 0;
+    for (size_t i = 0; i < PTRS_CNT; ++i) {
+        rset.add(make_ptr(0, i));
+        consumed += rset.consume([] (byte*) {});
+    }
+    rset.flush_buffers();
+    consumed += rset.consume([] (byte*) {});
+    EXPECT_EQ(PTRS_CNT, consumed);
+    EXPECT_TRUE(rset.empty());
+}
+
+TEST(remset_test, test_overflow)
+{
+    remset rset(1);
+
+    for (size_t i = 0; i < PTRS_CNT; ++i) {
+        rset.add(make_ptr(0, i));
+    }
+    rset.flush_buffers();
+
+    EXPECT_EQ(PTRS_CNT, rset.size());
+    std::vector<byte*> ptrs = consume_all(rset);
+    ASSERT_EQ(PTRS_CNT, ptrs.size());
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+        EXPECT_EQ(make_ptr(0, i), ptrs[i]);
+    }
+}
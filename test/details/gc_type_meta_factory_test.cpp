@@ -3,6 +3,7 @@
 #include <thread>
 #include <vector>
 #include <algorithm>
+#include <cstddef>
 
 #include <liballocgc/gc_type_meta.hpp>
 #include <liballocgc/details/utils/barrier.hpp>
@@ -52,8 +53,17 @@ struct nonmovable_type : private utils::noncopyable, private utils::nonmovable
     nonmovable_type() = default;
 };
 
+struct type_with_layout
+{
+    gc_handle m_ptr1;
+    size_t    m_data;
+    gc_handle m_ptr2;
+};
+
 }
 
+ALLOCGC_DECLARE_TYPE_LAYOUT(type_with_layout, offsetof(type_with_layout, m_ptr1), offsetof(type_with_layout, m_ptr2))
+
 TEST(gc_type_meta_factory_test, test_get)
 {
     EXPECT_EQ(nullptr, gc_type_meta_factory<type_1>::get());
@@ -70,6 +80,29 @@ TEST(gc_type_meta_factory_test, test_create)
     EXPECT_TRUE(std::equal(offsets.begin(), offsets.end(), factory::get()->offsets().begin()));
 }
 
+TEST(gc_type_meta_factory_test, test_declared_layout)
+{
+    typedef gc_type_meta_factory<type_with_layout> factory;
+    const gc_type_meta* tmeta = factory::get();
+    ASSERT_NE(nullptr, tmeta);
+    EXPECT_EQ(sizeof(type_with_layout), tmeta->type_size());
+
+    vector<size_t> offsets({offsetof(type_with_layout, m_ptr1), offsetof(type_with_layout, m_ptr2)});
+    EXPECT_EQ(offsets.size(), tmeta->offsets().size());
+    EXPECT_TRUE(std::equal(offsets.begin(), offsets.end(), tmeta->offsets().begin()));
+    EXPECT_EQ(0b101, tmeta->pointers_mask());
+}
+
+TEST(gc_type_meta_factory_test, test_unaligned_offsets)
+{
+    // offsets which do not fit into the pointers mask are traced by the offsets vector
+    typedef gc_type_meta_factory<type_2> factory;
+    vector<size_t> offsets({1, 2, 3});
+    factory::create(offsets.begin(), offsets.end());
+    ASSERT_NE(nullptr, factory::get());
+    EXPECT_EQ(0, factory::get()->pointers_mask());
+}
+
 TEST(gc_type_meta_factory_test, test_destroy)
 {
     typedef gc_type_meta_factory<type_with_dtor> factory;
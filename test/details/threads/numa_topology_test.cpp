@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <liballocgc/details/threads/numa_topology.hpp>
+#include <liballocgc/details/allocators/gc_core_allocator.hpp>
+#include <liballocgc/details/utils/scope_guard.hpp>
+
+using namespace allocgc;
+using namespace allocgc::details;
+using namespace allocgc::details::threads;
+
+namespace {
+static const size_t FAKE_NODES_COUNT = 2;
+}
+
+struct numa_topology_test : public ::testing::Test
+{
+    numa_topology_test()
+    {
+        numa_topology::set_fake_nodes_count(FAKE_NODES_COUNT);
+    }
+
+    ~numa_topology_test()
+    {
+        numa_topology::set_fake_nodes_count(0);
+    }
+};
+
+TEST_F(numa_topology_test, test_fake_topology)
+{
+    ASSERT_TRUE(numa_topology::is_fake());
+    ASSERT_EQ(FAKE_NODES_COUNT, numa_topology::nodes_count());
+
+    size_t node1 = 0;
+    size_t node2 = 0;
+    std::thread([&node1] { node1 = numa_topology::current_node(); }).join();
+    std::thread([&node2] { node2 = numa_topology::current_node(); }).join();
+
+    ASSERT_GT(FAKE_NODES_COUNT, node1);
+    ASSERT_GT(FAKE_NODES_COUNT, node2);
+    ASSERT_NE(node1, node2);
+}
+
+TEST_F(numa_topology_test, test_node_page_pools)
+{
+    allocators::gc_core_allocator core_alloc;
+    ASSERT_EQ(FAKE_NODES_COUNT, core_alloc.numa_nodes_count());
+
+    byte* page1 = core_alloc.allocate(PAGE_SIZE, 1);
+    ASSERT_NE(nullptr, page1);
+    core_alloc.deallocate(page1, PAGE_SIZE, 1);
+
+    byte* page0 = core_alloc.allocate(PAGE_SIZE, 0);
+    ASSERT_NE(page1, page0);
+
+    byte* page2 = core_alloc.allocate(PAGE_SIZE, 1);
+    ASSERT_EQ(page1, page2);
+
+    core_alloc.deallocate(page0, PAGE_SIZE, 0);
+    core_alloc.deallocate(page2, PAGE_SIZE, 1);
+}
@@ -157,3 +157,30 @@ TEST(sync_bitset_test, test_synchronization)
         ASSERT_TRUE(bits.get(i));
     });
 }
+
+TEST(sync_bitset_test, test_test_and_set)
+{
+    static const size_t SIZE = 2 * ULL_SIZE;
+    static const size_t THREADS_CNT = 8;
+    sync_bitset<SIZE> bits;
+
+    // each bit should be set exactly by one thread
+    std::atomic<size_t> set_cnt(0);
+    scoped_thread threads[THREADS_CNT];
+    for (auto& thread: threads) {
+        thread = std::thread([&bits, &set_cnt] {
+            for (size_t i = 0; i < SIZE; ++i) {
+                if (!bits.test_and_set(i)) {
+                    set_cnt.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(SIZE, set_cnt.load());
+    ASSERT_TRUE(bits.all());
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <liballocgc/details/utils/chase_lev_deque.hpp>
+
+using namespace allocgc::details::utils;
+
+namespace {
+const size_t CAPACITY = 64;
+}
+
+TEST(chase_lev_deque_test, test_push_pop)
+{
+    chase_lev_deque<int, CAPACITY> deque;
+    int items[3];
+
+    ASSERT_TRUE(deque.empty());
+    ASSERT_EQ(nullptr, deque.pop());
+
+    for (auto& item: items) {
+        ASSERT_TRUE(deque.push(&item));
+    }
+    ASSERT_FALSE(deque.empty());
+
+    // owner pops in LIFO order
+    ASSERT_EQ(&items[2], deque.pop());
+    // thieves steal in FIFO order
+    ASSERT_EQ(&items[0], deque.steal());
+    ASSERT_EQ(&items[1], deque.pop());
+
+    ASSERT_TRUE(deque.empty());
+    ASSERT_EQ(nullptr, deque.steal());
+}
+
+TEST(chase_lev_deque_test, test_overflow)
+{
+    chase_lev_deque<int, CAPACITY> deque;
+    std::vector<int> items(CAPACITY + 1);
+
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        ASSERT_TRUE(deque.push(&items[i]));
+    }
+    ASSERT_FALSE(deque.push(&items[CAPACITY]));
+}
+
+TEST(chase_lev_deque_test, test_concurrent_steal)
+{
+    static const size_t ITEMS_COUNT = 10000;
+    static const size_t THIEVES_COUNT = 3;
+
+    chase_lev_deque<int, CAPACITY> deque;
+    std::vector<int> items(ITEMS_COUNT, 0);
+    std::atomic<size_t> taken(0);
+
+    std::vector<std::thread> thieves;
+    for (size_t i = 0; i < THIEVES_COUNT; ++i) {
+        thieves.emplace_back([&deque, &taken] {
+            while (taken.load() < ITEMS_COUNT) {
+                int* item = deque.steal();
+                if (item) {
+                    ++(*item);
+                    ++taken;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    size_t pushed = 0;
+    while (pushed < ITEMS_COUNT) {
+        if (deque.push(&items[pushed])) {
+            ++pushed;
+        }
+        if (pushed % 2 == 0) {
+            int* item = deque.pop();
+            if (item) {
+                ++(*item);
+                ++taken;
+            }
+        }
+    }
+    while (int* item = deque.pop()) {
+        ++(*item);
+        ++taken;
+    }
+
+    for (auto& thief: thieves) {
+        thief.join();
+    }
+
+    // each item is taken exactly once
+    for (int item: items) {
+        ASSERT_EQ(1, item);
+    }
+}
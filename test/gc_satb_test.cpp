@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <liballocgc/liballocgc.hpp>
+#include <liballocgc/details/gc_facade.hpp>
+
+using namespace allocgc;
+using namespace allocgc::satb;
+
+namespace {
+
+const int VALUE = 42;
+
+struct node
+{
+    static size_t dtor_cnt;
+
+    node()
+        : value(VALUE)
+    {}
+
+    ~node()
+    {
+        ++dtor_cnt;
+    }
+
+    gc_ptr<node> next;
+    int value;
+};
+
+size_t node::dtor_cnt = 0;
+
+}
+
+TEST(gc_satb_test, test_overwritten_ptr)
+{
+    // the main thread is registered in the serial gc, so the test runs in its own thread
+    std::thread thread([] {
+        typedef details::gc_facade<details::collectors::gc_satb> gc_facade_t;
+
+        // without spare cores the marking is incremental and does not progress until the remark,
+        // unless something is allocated
+        set_threads_available(1);
+        register_main_thread();
+
+        {
+            gc_ptr<node> root = gc_new<node>();
+            root->next = gc_new<node>();
+            node::dtor_cnt = 0;
+
+            gc_options opt;
+            opt.kind = gc_kind::LAUNCH_CONCURRENT_MARK;
+            opt.gen  = -1;
+            gc_facade_t::initiation_point(details::initiation_point_type::USER_REQUEST, opt);
+
+            // the old target is reachable only from the stack handle created after the roots have been traced,
+            // so only the barrier keeps it alive
+            gc_ptr<node> old = root->next;
+            root->next = nullptr;
+
+            gc();
+
+            EXPECT_EQ(0, node::dtor_cnt);
+            EXPECT_EQ(VALUE, old->value);
+        }
+
+        deregister_thread(std::this_thread::get_id());
+    });
+    thread.join();
+}
@@ -19,6 +19,8 @@ public:
     MOCK_METHOD2(set_mark, void(byte* ptr, bool mark));
     MOCK_METHOD2(set_pin, void(byte* ptr, bool pin));
 
+    MOCK_METHOD1(try_mark, bool(byte* ptr));
+
     MOCK_CONST_METHOD1(is_init, bool(byte*));
 
     MOCK_CONST_METHOD1(get_lifetime_tag, gc_lifetime_tag(byte* ptr));
@@ -35,6 +37,8 @@ public:
     MOCK_CONST_METHOD2(trace, void(byte*, const gc_trace_callback&));
     MOCK_METHOD3(move, void(byte*, byte*, memory_descriptor*));
     MOCK_METHOD1(finalize, void(byte*));
+
+    MOCK_CONST_METHOD0(numa_node, size_t());
 };
 
 
@@ -13,7 +13,7 @@ struct page_ptr_deleter
     {
         using namespace allocgc::details;
         using namespace allocgc::details::allocators;
-        gc_core_allocator().deallocate(mem, PAGE_SIZE);
+        gc_core_allocator().deallocate(mem, PAGE_SIZE, 0);
     }
 };
 
@@ -23,7 +23,7 @@ page_ptr make_page_ptr()
 {
     using namespace allocgc::details;
     using namespace allocgc::details::allocators;
-    byte* p = gc_core_allocator().allocate(PAGE_SIZE, false);
+    byte* p = gc_core_allocator().allocate(PAGE_SIZE, 0);
     assert(p);
     return page_ptr(p);
 }
@@ -74,7 +74,8 @@ class GCTimeParser:
             "FULL_TIME" : {"cmd": partial(parse_int, "full_time"), "re": "Completed in (?P<full_time>\d*) ms"},
             "GC_TIME"   : {"cmd": partial(parse_int, "gc_time"), "re": "Time spent in gc (?P<gc_time>\d*) ms"},
             "STW_TIME"  : {"cmd": partial(parse_int, "stw_time"), "re": "Average pause time (?P<stw_time>\d*) us"},
-            "GC_COUNT"  : {"cmd": partial(parse_int, "gc_count"), "re": "Completed (?P<gc_count>\d*) collections"}
+            "GC_COUNT"  : {"cmd": partial(parse_int, "gc_count"), "re": "Completed (?P<gc_count>\d*) collections"},
+            "MARK_TPUT" : {"cmd": partial(parse_int, "mark_tput"), "re": "Mark throughput (?P<mark_tput>\d*) MB/s"}
         }
 
         self._scanner = Scanner(token_spec)
@@ -102,7 +103,8 @@ class GCTimeParser:
                 "min" : self._us_to_ms(stat_min(self._context["stw_time"]), ndigits=3),
                 "max" : self._us_to_ms(stat_max(self._context["stw_time"]), ndigits=3)
             },
-            "gc_count": stat_mean(self._context["gc_count"], default=0, ndigits=0)
+            "gc_count": stat_mean(self._context["gc_count"], default=0, ndigits=0),
+            "mark_tput": stat_mean(self._context["mark_tput"], ndigits=0)
         }
 
     @staticmethod